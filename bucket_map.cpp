@@ -45,4 +45,53 @@ vector<WeakPointer<T>> BucketMap<T>::getElements(Rectangle area) const {
   return ret;
 }
 
+template<class T>
+void BucketMap<T>::getClosest(Vec2 pos, int maxDist, int maxCount, function<bool(WeakPointer<T>)> predicate,
+    vector<WeakPointer<T>>& result) const {
+  result.clear();
+  if (maxCount <= 0)
+    return;
+  auto getDist = [&](WeakPointer<T> elem) { return elem->getPosition().getCoord().dist8(pos); };
+  auto visitBucket = [&](Vec2 bucket) {
+    if (!bucket.inRectangle(buckets.getBounds()))
+      return;
+    for (auto elem : buckets[bucket].getElems()) {
+      int dist = getDist(elem);
+      if (dist > maxDist || (result.size() == maxCount && dist >= getDist(result.back())) || !predicate(elem))
+        continue;
+      result.push_back(elem);
+      for (int i = result.size() - 1; i > 0 && getDist(result[i - 1]) > dist; --i)
+        std::swap(result[i - 1], result[i]);
+      if (result.size() > maxCount)
+        result.pop_back();
+    }
+  };
+  Vec2 center(pos.x / bucketSize, pos.y / bucketSize);
+  int maxRing = max(buckets.getWidth(), buckets.getHeight());
+  // Elements in ring r are at least (r - 1) * bucketSize + 1 away from the position.
+  for (int ring = 0; ring <= maxRing && (ring - 1) * bucketSize < maxDist; ++ring) {
+    if (ring == 0)
+      visitBucket(center);
+    else {
+      for (int x = center.x - ring; x <= center.x + ring; ++x) {
+        visitBucket(Vec2(x, center.y - ring));
+        visitBucket(Vec2(x, center.y + ring));
+      }
+      for (int y = center.y - ring + 1; y < center.y + ring; ++y) {
+        visitBucket(Vec2(center.x - ring, y));
+        visitBucket(Vec2(center.x + ring, y));
+      }
+    }
+    if (result.size() == maxCount && getDist(result.back()) <= ring * bucketSize)
+      return;
+  }
+}
+
+template<class T>
+WeakPointer<T> BucketMap<T>::getClosest(Vec2 pos, int maxDist, function<bool(WeakPointer<T>)> predicate) const {
+  vector<WeakPointer<T>> result;
+  getClosest(pos, maxDist, 1, std::move(predicate), result);
+  return result.empty() ? nullptr : result[0];
+}
+
 template class BucketMap<Creature>;
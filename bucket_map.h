@@ -15,6 +15,12 @@ class BucketMap {
 
   vector<WeakPointer<T>> getElements(Rectangle area) const;
 
+  /** Writes up to maxCount elements within maxDist of the position that satisfy the predicate to the buffer,
+      closest first. Buckets are visited in growing rings, so the search stops when no closer element can exist.*/
+  void getClosest(Vec2, int maxDist, int maxCount, function<bool(WeakPointer<T>)>,
+      vector<WeakPointer<T>>& result) const;
+  WeakPointer<T> getClosest(Vec2, int maxDist, function<bool(WeakPointer<T>)>) const;
+
   SERIALIZATION_DECL(BucketMap);
 
   private:
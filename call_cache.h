@@ -3,56 +3,135 @@
 #include "stdafx.h"
 #include "hashing.h"
 #include "util.h"
+#include "entity_index.h"
 
+/** Memoizes results of function calls, evicting the least recently used entry when full. Lookups, insertions
+    and evictions are O(1): entries are kept in a dense vector with a hash index and an intrusive LRU list.*/
 template <typename Value>
 class CallCache {
   public:
   CallCache(int size) : maxSize(size) {}
 
-  typedef pair<int, int> Key;
-
   template <typename... Args, typename Generator>
   Value get(Generator gen, int id, Args&&...args) {
-    Key key = {id, combineHash(args...)};
-    if (auto elem = getValue(key))
-      return *elem;
-    else
+    Key key {id, (int) combineHash(args...)};
+    if (auto index = find(key)) {
+      ++numHits;
+      moveToFront(*index);
+      return elems[*index].value;
+    } else {
+      ++numMisses;
       return insertValue(key, gen(std::forward<Args>(args)...));
+    }
   }
 
   int getSize() const {
-    return cache.size();
+    return elems.size();
   }
 
   template <typename... Args>
   bool contains(int id, Args...args) {
-    return cache.count({id, combineHash(args...)});
+    return !!find(Key{id, (int) combineHash(args...)});
+  }
+
+  int getNumHits() const {
+    return numHits;
+  }
+
+  int getNumMisses() const {
+    return numMisses;
   }
 
   private:
-  Value& insertValue(Key key, Value value) {
-    if (cache.size() >= maxSize) {
-      CHECK(!lastUsed.isEmpty());
-      pair<const int, Key> lru = lastUsed.getFront2();
-      lastUsed.erase(lru.first);
-      cache.erase(lru.second);
+  struct Key {
+    int id;
+    int hash;
+    bool operator == (const Key& o) const {
+      return id == o.id && hash == o.hash;
     }
-    if (lastUsed.contains(key))
-      lastUsed.erase(key);
-    lastUsed.insert(key, ++cnt);
-    return cache[key] = value;
+    int getHash() const {
+      return (int) combineHash(id, hash);
+    }
+  };
+
+  struct Elem {
+    Key key;
+    Value value;
+    int prev;
+    int next;
+  };
+
+  optional<int> find(const Key& key) const {
+    return index.find(key, getKeyFun());
   }
 
-  optional<Value&> getValue(Key key) {
-    if (auto elem = getReferenceMaybe(cache, key)) {
-      lastUsed.erase(key);
-      lastUsed.insert(key, ++cnt);
-      return *elem;
-    } else
-      return none;
+  auto getKeyFun() const {
+    return [this](int i) -> const Key& { return elems[i].key; };
+  }
+
+  void unlink(int i) {
+    if (elems[i].prev != -1)
+      elems[elems[i].prev].next = elems[i].next;
+    else
+      head = elems[i].next;
+    if (elems[i].next != -1)
+      elems[elems[i].next].prev = elems[i].prev;
+    else
+      tail = elems[i].prev;
   }
+
+  void linkFront(int i) {
+    elems[i].prev = -1;
+    elems[i].next = head;
+    if (head != -1)
+      elems[head].prev = i;
+    else
+      tail = i;
+    head = i;
+  }
+
+  void moveToFront(int i) {
+    if (head != i) {
+      unlink(i);
+      linkFront(i);
+    }
+  }
+
+  void eraseIndex(int i) {
+    unlink(i);
+    index.erase(elems[i].key, getKeyFun());
+    int last = elems.size() - 1;
+    if (i != last) {
+      index.move(elems[last].key, i, getKeyFun());
+      elems[i] = std::move(elems[last]);
+      if (elems[i].prev != -1)
+        elems[elems[i].prev].next = i;
+      else
+        head = i;
+      if (elems[i].next != -1)
+        elems[elems[i].next].prev = i;
+      else
+        tail = i;
+    }
+    elems.pop_back();
+  }
+
+  const Value& insertValue(Key key, Value value) {
+    if (elems.size() >= maxSize) {
+      CHECK(tail != -1);
+      eraseIndex(tail);
+    }
+    elems.push_back(Elem{key, std::move(value), -1, -1});
+    index.insert(getKeyFun());
+    linkFront(elems.size() - 1);
+    return elems.back().value;
+  }
+
   const int maxSize;
-  unordered_map<Key, Value, CustomHash<Key>> cache;
-  BiMap<Key, int> lastUsed;
-  int cnt = 0;
+  vector<Elem> elems;
+  EntityIndex<Key> index;
+  int head = -1;
+  int tail = -1;
+  int numHits = 0;
+  int numMisses = 0;
 };
@@ -181,6 +181,7 @@ void Collective::addCreature(WCreature c, EnumSet<MinionTrait> traits) {
 
 void Collective::removeCreature(WCreature c) {
   creatures.removeElement(c);
+  minionEquipment->removeOwner(c);
   returnResource(taskMap->freeFromTask(c));
   for (auto team : teams->getContaining(c))
     teams->remove(team, c);
@@ -384,8 +385,10 @@ void Collective::orderConsumption(WCreature consumer, WCreature who) {
 PTask Collective::getEquipmentTask(WCreature c) {
   if (!usesEquipment(c))
     return nullptr;
-  if (!hasTrait(c, MinionTrait::NO_AUTO_EQUIPMENT) && Random.roll(40))
+  if (!hasTrait(c, MinionTrait::NO_AUTO_EQUIPMENT) && Random.roll(40)) {
+    minionEquipment->updateOwner(c);
     minionEquipment->autoAssign(c, getAllItems(ItemIndex::MINION_EQUIPMENT, false));
+  }
   vector<PTask> tasks;
   for (WItem it : c->getEquipment().getItems())
     if (!c->getEquipment().isEquipped(it) && c->getEquipment().canEquip(it))
@@ -568,10 +571,10 @@ void Collective::setControl(PCollectiveControl c) {
 
 vector<Position> Collective::getEnemyPositions() const {
   vector<Position> enemyPos;
-  for (Position pos : territory->getExtended(10))
-    if (WConstCreature c = pos.getCreature())
-      if (getTribe()->isEnemy(c))
-        enemyPos.push_back(pos);
+  for (auto& elem : territory->getExtendedBounds(10))
+    for (WConstCreature c : elem.first->getAllCreatures(elem.second))
+      if (getTribe()->isEnemy(c) && territory->isInExtended(c->getPosition(), 0, 10))
+        enemyPos.push_back(c->getPosition());
   return enemyPos;
 }
 
@@ -643,21 +646,65 @@ void Collective::tick() {
       }
     }
   }
-  if (config->getConstructions())
+  if (config->getConstructions()) {
     updateConstructions();
-  if (config->getFetchItems() && Random.roll(5))
-    for (const ItemFetchInfo& elem : CollectiveConfig::getFetchInfo()) {
-      for (Position pos : territory->getAll())
-        fetchItems(pos, elem);
+    taskMap->assignTasks(getCreatures(MinionTrait::WORKER).filter([this](WConstCreature c) {
+        auto current = currentTasks.getMaybe(c);
+        return !taskMap->hasTask(c) &&
+            (!current || config->getTaskInfo(current->task).type == MinionTaskInfo::WORKER); }));
+  }
+  if (config->getFetchItems()) {
+    for (Position pos : zones->extractChangedPositions())
+      onItemsChanged(pos);
+    for (Position pos : taskMap->extractRemovedPositions())
+      onItemsChanged(pos);
+    // Every change of the items on a tile is logged by its level, including thrown items and ones dropped by
+    // destroyed furniture. Everything is looked at if some changes were missed, e.g. after loading.
+    for (WLevel level : getModel()->getLevels()) {
+      auto version = itemsVersions.find(level->getUniqueId());
+      optional<vector<Vec2>> changes;
+      if (version != itemsVersions.end())
+        changes = level->getItemChanges(version->second);
+      itemsVersions[level->getUniqueId()] = level->getItemsVersion();
+      if (changes)
+        for (Vec2 v : *changes)
+          onItemsChanged(Position(v, level));
+      else
+        fetchAllItems = true;
+    }
+    if (fetchAllItems) {
+      fetchAllItems = false;
+      for (const ItemFetchInfo& elem : CollectiveConfig::getFetchInfo())
+        for (Position pos : getItemPositions(elem.index))
+          itemsToFetch.insert(pos);
       for (Position pos : zones->getPositions(ZoneId::FETCH_ITEMS))
-        fetchItems(pos, elem);
+        itemsToFetch.insert(pos);
       for (Position pos : zones->getPositions(ZoneId::PERMANENT_FETCH_ITEMS))
-        fetchItems(pos, elem);
+        itemsToFetch.insert(pos);
+    }
+    if (Random.roll(5)) {
+      PositionSet positions;
+      swap(positions, itemsToFetch);
+      for (Position pos : positions)
+        if (fetchItems(pos))
+          itemsToFetch.insert(pos);
     }
-  if (config->getManageEquipment() && Random.roll(40)) {
-    minionEquipment->updateOwners(getCreatures());
-    minionEquipment->updateItems(getAllItems(ItemIndex::MINION_EQUIPMENT, true));
+  } else {
+    zones->extractChangedPositions();
+    taskMap->extractRemovedPositions();
   }
+  minionEquipment->clearCache();
+  // Items can leave the collective without an event, e.g. when they are thrown.
+  if (config->getManageEquipment() && getLocalTime().getVisibleInt() % 40 == 0)
+    minionEquipment->removeLostItems(getCreatures(),
+        [this] { return getAllItems(ItemIndex::MINION_EQUIPMENT, true); });
+#ifndef RELEASE
+  // Doesn't draw from Random, so that debug and release games play out the same.
+  if (config->getManageEquipment() && getLocalTime().getVisibleInt() % 40 == 0)
+    if (int numOutdated = minionEquipment->countOutdatedOwners(getCreatures(),
+          getAllItems(ItemIndex::MINION_EQUIPMENT, true)))
+      INFO << "Equipment ownership out of date for " << numOutdated << " items";
+#endif
   workshops->scheduleItems(this);
 }
 
@@ -720,6 +767,20 @@ void Collective::onEvent(const GameEvent& event) {
               c->removeEffect(LastingEffect::SLEEP);
         }
       },
+      [&](const ItemsDropped& info) {
+        if (!territory->contains(info.creature->getPosition()))
+          for (auto item : info.items)
+            minionEquipment->discard(item);
+      },
+      [&](const ItemsPickedUp& info) {
+        if (!creatures.contains(info.creature))
+          for (auto item : info.items)
+            minionEquipment->discard(item);
+      },
+      [&](const ItemsEquipped& info) {
+        if (creatures.contains(info.creature))
+          minionEquipment->updateOwner(info.creature);
+      },
       [&](const CreatureKilled& info) {
         if (creatures.contains(info.victim))
           onMinionKilled(info.victim, info.attacker);
@@ -840,6 +901,7 @@ bool Collective::canClaimSquare(Position pos) const {
 void Collective::claimSquare(Position pos) {
   //CHECK(canClaimSquare(pos));
   territory->insert(pos);
+  onItemsChanged(pos);
   for (auto furniture : pos.modFurniture())
     if (!furniture->isWall()) {
       if (!constructions->containsFurniture(pos, furniture->getLayer()))
@@ -923,9 +985,9 @@ void Collective::returnResource(const CostInfo& amount) {
     return;
   CHECK(amount.value > 0);
   if (auto storageType = config->getResourceInfo(amount.id).storageDestination) {
-    const set<Position>& destination = storageType(this);
+    const PositionSet& destination = storageType(this);
     if (!destination.empty()) {
-      Random.choose(destination).dropItems(config->getResourceInfo(amount.id).itemId.get(amount.value));
+      Random.choose(destination.getElems()).dropItems(config->getResourceInfo(amount.id).itemId.get(amount.value));
       return;
     }
   }
@@ -947,6 +1009,14 @@ bool Collective::usesEquipment(WConstCreature c) const {
     && !hasTrait(c, MinionTrait::PRISONER);
 }
 
+vector<Position> Collective::getItemPositions(ItemIndex index) const {
+  vector<Position> ret;
+  for (Position pos : level->getItemPositions(index))
+    if (territory->contains(pos))
+      ret.push_back(pos);
+  return ret;
+}
+
 vector<WItem> Collective::getAllItems(bool includeMinions) const {
   vector<WItem> allItems;
   for (Position v : territory->getAll())
@@ -969,7 +1039,7 @@ vector<WItem> Collective::getAllItems(ItemPredicate predicate, bool includeMinio
 
 vector<WItem> Collective::getAllItems(ItemIndex index, bool includeMinions) const {
   vector<WItem> allItems;
-  for (Position v : territory->getAll())
+  for (Position v : getItemPositions(index))
     append(allItems, v.getItems(index));
   if (includeMinions)
     for (WCreature c : getCreatures())
@@ -986,7 +1056,7 @@ bool Collective::canPillage() const {
 
 int Collective::getNumItems(ItemIndex index, bool includeMinions) const {
   int ret = 0;
-  for (Position v : territory->getAll())
+  for (Position v : getItemPositions(index))
     ret += v.getItems(index).size();
   if (includeMinions)
     for (WCreature c : getCreatures())
@@ -994,7 +1064,7 @@ int Collective::getNumItems(ItemIndex index, bool includeMinions) const {
   return ret;
 }
 
-optional<set<Position>> Collective::getStorageFor(WConstItem item) const {
+optional<PositionSet> Collective::getStorageFor(WConstItem item) const {
   for (auto& info : config->getFetchInfo())
     if (getIndexPredicate(info.index)(item))
       return info.destinationFun(this);
@@ -1158,6 +1228,7 @@ void Collective::onDestructed(Position pos, FurnitureType type, const DestroyAct
       break;
     case DestroyAction::Type::DIG:
       territory->insert(pos);
+      onItemsChanged(pos);
       break;
     default:
       break;
@@ -1265,12 +1336,12 @@ bool Collective::isDelayed(Position pos) {
 }
 
 void Collective::fetchItems(Position pos, const ItemFetchInfo& elem) {
-  if (isDelayed(pos) || !pos.canEnterEmpty(MovementTrait::WALK) || elem.destinationFun(this).count(pos))
+  if (isDelayed(pos) || !pos.canEnterEmpty(MovementTrait::WALK) || elem.destinationFun(this).contains(pos))
     return;
   vector<WItem> equipment = pos.getItems(elem.index).filter(
       [this, &elem] (WConstItem item) { return elem.predicate(this, item); });
   if (!equipment.empty()) {
-    const set<Position>& destination = elem.destinationFun(this);
+    const PositionSet& destination = elem.destinationFun(this);
     if (!destination.empty()) {
       warnings->setWarning(elem.warning, false);
       if (elem.oneAtATime)
@@ -1283,6 +1354,32 @@ void Collective::fetchItems(Position pos, const ItemFetchInfo& elem) {
   }
 }
 
+bool Collective::isFetchArea(Position pos) const {
+  return territory->contains(pos) || zones->isZone(pos, ZoneId::FETCH_ITEMS) ||
+      zones->isZone(pos, ZoneId::PERMANENT_FETCH_ITEMS);
+}
+
+void Collective::onItemsChanged(Position pos) {
+  if (config->getFetchItems() && isFetchArea(pos))
+    itemsToFetch.insert(pos);
+}
+
+bool Collective::fetchItems(Position pos) {
+  if (!isFetchArea(pos) || !pos.canEnterEmpty(MovementTrait::WALK))
+    return false;
+  // Keep looking at the position until all items that could be fetched are taken away, because some of them
+  // might be delayed or wait for a storage to be built. Marked items are looked at again when their task is
+  // removed.
+  bool itemsLeft = false;
+  for (const ItemFetchInfo& elem : CollectiveConfig::getFetchInfo()) {
+    fetchItems(pos, elem);
+    if (!elem.destinationFun(this).contains(pos) && !pos.getItems(elem.index).filter(
+          [this, &elem] (WConstItem item) { return elem.predicate(this, item); }).empty())
+      itemsLeft = true;
+  }
+  return itemsLeft;
+}
+
 void Collective::handleSurprise(Position pos) {
   Vec2 rad(8, 8);
   WCreature c = pos.getCreature();
@@ -1567,7 +1664,7 @@ int Collective::getPopulationSize() const {
 int Collective::getMaxPopulation() const {
   int ret = config->getMaxPopulation();
   for (auto& elem : config->getPopulationIncreases()) {
-    int sz = getConstructions().getBuiltPositions(elem.type).size();
+    int sz = getConstructions().getBuiltPositions(elem.type).getSize();
     ret += min<int>(elem.maxIncrease, elem.increasePerSquare * sz);
   }
   return ret;
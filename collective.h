@@ -21,6 +21,7 @@
 #include "event_listener.h"
 #include "entity_map.h"
 #include "minion_trait.h"
+#include "position_set.h"
 
 class CollectiveAttack;
 class Creature;
@@ -48,6 +49,7 @@ struct ItemFetchInfo;
 class CollectiveWarnings;
 class Immigration;
 class Quarters;
+class PositionSet;
 
 class Collective : public TaskCallback, public UniqueEntity<Collective>, public EventListener<Collective> {
   public:
@@ -133,6 +135,8 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   vector<WItem> getAllItems(bool includeMinions = true) const;
   vector<WItem> getAllItems(ItemPredicate predicate, bool includeMinions = true) const;
   vector<WItem> getAllItems(ItemIndex, bool includeMinions = true) const;
+  /** Returns the territory positions that hold items of the given index.*/
+  vector<Position> getItemPositions(ItemIndex) const;
 
   vector<pair<WItem, Position>> getTrapItems(TrapType, const vector<Position>&) const;
 
@@ -199,7 +203,7 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   void updateResourceProduction();
   bool isItemMarked(WConstItem) const;
   int getNumItems(ItemIndex, bool includeMinions = true) const;
-  optional<set<Position>> getStorageFor(WConstItem) const;
+  optional<PositionSet> getStorageFor(WConstItem) const;
 
   void addKnownVillain(WConstCollective);
   bool isKnownVillain(WConstCollective) const;
@@ -233,6 +237,15 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   void onKilledSomeone(WCreature victim, WCreature killer);
 
   void fetchItems(Position, const ItemFetchInfo&);
+  bool fetchItems(Position);
+  bool isFetchArea(Position) const;
+  void onItemsChanged(Position);
+  /** Positions whose items need to be looked at by the next fetching pass. Not serialized, because all
+      positions are looked at after loading.*/
+  PositionSet itemsToFetch;
+  bool fetchAllItems = true;
+  /** Items versions of the levels when their changes were last added to itemsToFetch.*/
+  unordered_map<LevelId, int> itemsVersions;
 
   void addMoraleForKill(WConstCreature killer, WConstCreature victim);
   void decreaseMoraleForKill(WConstCreature killer, WConstCreature victim);
@@ -4,6 +4,7 @@
 #include "tribe.h"
 #include "furniture.h"
 #include "furniture_factory.h"
+#include "level.h"
 
 SERIALIZATION_CONSTRUCTOR_IMPL2(ConstructionMap::FurnitureInfo, FurnitureInfo);
 
@@ -72,6 +73,7 @@ void ConstructionMap::removeFurniture(Position pos, FurnitureLayer layer) {
     addDebt(-info->getCost());
   }
   furniturePositions[type].erase(pos);
+  onPositionsChanged(type);
   info = none;
   allFurniture.removeElement({pos, layer});
   pos.setNeedsRenderUpdate(true);
@@ -100,9 +102,10 @@ void ConstructionMap::addFurniture(Position pos, const FurnitureInfo& info) {
   allFurniture.push_back({pos, layer});
   furniture[layer].set(pos, info);
   pos.setNeedsRenderUpdate(true);
-  if (info.isBuilt())
+  if (info.isBuilt()) {
     furniturePositions[info.getFurnitureType()].insert(pos);
-  else {
+    onPositionsChanged(info.getFurnitureType());
+  } else {
     ++unbuiltCounts[info.getFurnitureType()];
     addDebt(info.getCost());
   }
@@ -113,17 +116,57 @@ bool ConstructionMap::containsFurniture(Position pos, FurnitureLayer layer) cons
 }
 
 int ConstructionMap::getBuiltCount(FurnitureType type) const {
-  return (int) furniturePositions[type].size();
+  return furniturePositions[type].getSize();
 }
 
 int ConstructionMap::getTotalCount(FurnitureType type) const {
   return unbuiltCounts[type] + getBuiltCount(type);
 }
 
-const set<Position>& ConstructionMap::getBuiltPositions(FurnitureType type) const {
+const PositionSet& ConstructionMap::getBuiltPositions(FurnitureType type) const {
   return furniturePositions[type];
 }
 
+bool ConstructionMap::ReachableKey::operator == (const ReachableKey& o) const {
+  return type == o.type && movement == o.movement && level == o.level && sector == o.sector;
+}
+
+int ConstructionMap::ReachableKey::getHash() const {
+  return combineHash(type, movement, level, sector);
+}
+
+void ConstructionMap::onPositionsChanged(FurnitureType type) {
+  ++positionsVersion[type];
+}
+
+const vector<Position>& ConstructionMap::getReachablePositions(FurnitureType type, Position from,
+    const MovementType& movement) const {
+  static vector<Position> empty;
+  auto level = from.getLevel();
+  if (!level)
+    return empty;
+  int sectorsVersion = level->getSectorsVersion(movement);
+  ReachableKey key {type, movement, level->getUniqueId(), level->getSectorId(from.getCoord(), movement)};
+  auto it = reachableCache.find(key);
+  if (it != reachableCache.end() && it->second.positionsVersion == positionsVersion[type] &&
+      it->second.sectorsVersion == sectorsVersion)
+    return it->second.positions;
+  // Ids of sectors that no longer exist pile up, so start over once in a while.
+  if (reachableCache.size() > 1000)
+    reachableCache.clear();
+  auto& elem = reachableCache[key];
+  elem.positionsVersion = positionsVersion[type];
+  elem.sectorsVersion = sectorsVersion;
+  elem.positions.clear();
+  for (auto& pos : furniturePositions[type])
+    for (Position v : pos.neighbors8())
+      if (v.isConnectedTo(from, movement)) {
+        elem.positions.push_back(pos);
+        break;
+      }
+  return elem.positions;
+}
+
 const vector<pair<Position, FurnitureLayer>>& ConstructionMap::getAllFurniture() const {
   return allFurniture;
 }
@@ -133,6 +176,7 @@ void ConstructionMap::onConstructed(Position pos, FurnitureType type) {
   if (!containsFurniture(pos, layer))
     addFurniture(pos, FurnitureInfo::getBuilt(type));
   furniturePositions[type].insert(pos);
+  onPositionsChanged(type);
   --unbuiltCounts[type];
   if (furniture[layer].get(pos)) { // why this if?
     auto& info = *furniture[layer].getOrInit(pos);
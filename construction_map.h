@@ -8,6 +8,8 @@
 #include "furniture_layer.h"
 #include "resource_id.h"
 #include "position_map.h"
+#include "position_set.h"
+#include "movement_type.h"
 
 class ConstructionMap {
   public:
@@ -61,7 +63,10 @@ class ConstructionMap {
   bool containsFurniture(Position, FurnitureLayer) const;
   int getBuiltCount(FurnitureType) const;
   int getTotalCount(FurnitureType) const;
-  const set<Position>& getBuiltPositions(FurnitureType) const;
+  const PositionSet& getBuiltPositions(FurnitureType) const;
+  /** Returns the built positions of the furniture type that a creature standing at the given position can
+      navigate to. The result is cached until the furniture or the sectors of the level change.*/
+  const vector<Position>& getReachablePositions(FurnitureType, Position from, const MovementType&) const;
   void onConstructed(Position, FurnitureType);
 
   const optional<TrapInfo>& getTrap(Position) const;
@@ -79,11 +84,27 @@ class ConstructionMap {
 
   private:
   EnumMap<FurnitureLayer, PositionMap<optional<FurnitureInfo>>> SERIAL(furniture);
-  EnumMap<FurnitureType, set<Position>> SERIAL(furniturePositions);
+  EnumMap<FurnitureType, PositionSet> SERIAL(furniturePositions);
   EnumMap<FurnitureType, int> SERIAL(unbuiltCounts);
   vector<pair<Position, FurnitureLayer>> SERIAL(allFurniture);
   PositionMap<optional<TrapInfo>> SERIAL(traps);
   vector<Position> SERIAL(allTraps);
   EnumMap<CollectiveResourceId, int> SERIAL(debt);
   void addDebt(const CostInfo&);
+  void onPositionsChanged(FurnitureType);
+  struct ReachableKey {
+    FurnitureType type;
+    MovementType movement;
+    LevelId level;
+    int sector;
+    bool operator == (const ReachableKey&) const;
+    int getHash() const;
+  };
+  struct Reachable {
+    int positionsVersion;
+    int sectorsVersion;
+    vector<Position> positions;
+  };
+  mutable unordered_map<ReachableKey, Reachable, CustomHash<ReachableKey>> reachableCache;
+  EnumMap<FurnitureType, int> positionsVersion;
 };
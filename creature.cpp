@@ -680,6 +680,7 @@ bool Creature::knowsHiding(WConstCreature c) const {
 }
 
 void Creature::addEffect(LastingEffect effect, TimeInterval time, bool msg) {
+  onEffectsChanged(effect);
   if (LastingEffects::affects(this, effect) && !getBody().isImmuneTo(effect)) {
     bool was = isAffected(effect);
     attributes->addLastingEffect(effect, *getGlobalTime() + time);
@@ -689,6 +690,7 @@ void Creature::addEffect(LastingEffect effect, TimeInterval time, bool msg) {
 }
 
 void Creature::removeEffect(LastingEffect effect, bool msg) {
+  onEffectsChanged(effect);
   bool was = isAffected(effect);
   attributes->clearLastingEffect(effect, *getGlobalTime());
   if (was && !isAffected(effect))
@@ -696,6 +698,7 @@ void Creature::removeEffect(LastingEffect effect, bool msg) {
 }
 
 void Creature::addPermanentEffect(LastingEffect effect, int count) {
+  onEffectsChanged(effect);
   bool was = isAffected(effect);
   attributes->addPermanentEffect(effect, count);
   if (!was && isAffected(effect))
@@ -703,6 +706,7 @@ void Creature::addPermanentEffect(LastingEffect effect, int count) {
 }
 
 void Creature::removePermanentEffect(LastingEffect effect, int count) {
+  onEffectsChanged(effect);
   bool was = isAffected(effect);
   attributes->removePermanentEffect(effect, count);
   if (was && !isAffected(effect))
@@ -822,23 +826,36 @@ optional<GlobalTime> Creature::getGlobalTime() const {
     return none;
 }
 
-void Creature::tick() {
+void Creature::tick(TimeInterval elapsed) {
+  tick(elapsed, {});
+}
+
+void Creature::tick(TimeInterval elapsed, const vector<pair<LastingEffect, LastingEffectTurns>>& changedEffects) {
   vision->update(this);
   if (Random.roll(5))
     getDifficultyPoints();
+  int numTurns = elapsed.getVisibleInt();
   vector<WItem> discarded;
-  for (auto item : equipment->getItems()) {
-    item->tick(position);
-    if (item->isDiscarded())
-      discarded.push_back(item);
-  }
+  for (auto item : equipment->getItems())
+    for (int i : Range(numTurns)) {
+      item->tick(position);
+      if (item->isDiscarded()) {
+        discarded.push_back(item);
+        break;
+      }
+    }
   for (auto item : discarded)
     equipment->removeItem(item, this);
   for (LastingEffect effect : ENUM_ALL(LastingEffect)) {
     if (attributes->considerTimeout(effect, *getGlobalTime()))
       LastingEffects::onTimedOut(this, effect, true);
-    if (isAffected(effect) && LastingEffects::tick(this, effect))
-      return;
+    int turns = isAffected(effect) ? numTurns : 0;
+    for (auto& changed : changedEffects)
+      if (changed.first == effect)
+        turns = changed.second.before + (isAffected(effect) ? changed.second.since : 0);
+    for (int i : Range(turns))
+      if (LastingEffects::tick(this, effect))
+        return;
   }
   updateViewObject();
   if (getBody().tick(this)) {
@@ -847,6 +864,11 @@ void Creature::tick() {
   }
 }
 
+void Creature::onEffectsChanged(LastingEffect effect) {
+  if (auto model = position.getModel())
+    model->onEffectsChanged(this, effect);
+}
+
 void Creature::dropWeapon() {
   if (auto weapon = getWeapon())
     if (equipment->hasItem(weapon)) {
@@ -54,6 +54,7 @@ class CreatureDebt;
 class Vision;
 struct AdjectiveInfo;
 struct MovementInfo;
+struct LastingEffectTurns;
 
 class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedObject<Creature> {
   public:
@@ -92,7 +93,12 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   bool canSee(Position) const;
   bool canSee(Vec2) const;
   bool isEnemy(WConstCreature) const;
-  void tick();
+  /** Advances lasting effects, items and body by the given number of turns. Longer intervals are used to catch
+      up on creatures that are ticked less often, see Model::tick().*/
+  void tick(TimeInterval elapsed = 1_visible);
+  /** Same, but a lasting effect that changed during the interval is only advanced by the turns that it was
+      actually active for.*/
+  void tick(TimeInterval elapsed, const vector<pair<LastingEffect, LastingEffectTurns>>& changedEffects);
 
   const CreatureName& getName() const;
   CreatureName& getName();
@@ -287,6 +293,7 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   bool canCarry(const vector<WItem>&) const;
   TribeSet getFriendlyTribes() const;
   void addMovementInfo(MovementInfo);
+  void onEffectsChanged(LastingEffect);
   bool canSwapPositionInMovement(WCreature other) const;
 
   HeapAllocated<CreatureAttributes> SERIAL(attributes);
@@ -310,8 +317,8 @@ class Creature : public Renderable, public UniqueEntity<Creature>, public OwnedO
   mutable int SERIAL(difficultyPoints) = 0;
   int SERIAL(points) = 0;
   void updateVisibleCreatures();
-  vector<Position> visibleEnemies;
-  vector<Position> visibleCreatures;
+  vector<PackedPosition> visibleEnemies;
+  vector<PackedPosition> visibleCreatures;
   HeapAllocated<Vision> SERIAL(vision);
   bool forceMovement = false;
   optional<CombatIntentInfo> SERIAL(lastCombatIntent);
@@ -325,3 +332,10 @@ struct AdjectiveInfo {
   string name;
   const char* help;
 };
+
+struct LastingEffectTurns {
+  /** Turns that the effect was active for before its last change.*/
+  int before;
+  /** Turns since its last change, during which it's active if the creature is affected now.*/
+  int since;
+};
@@ -194,6 +194,13 @@ bool CreatureAttributes::considerTimeout(LastingEffect effect, GlobalTime curren
   return false;
 }
   
+bool CreatureAttributes::hasTimedLastingEffect(GlobalTime time) const {
+  for (LastingEffect effect : ENUM_ALL(LastingEffect))
+    if (lastingEffects[effect] > time)
+      return true;
+  return false;
+}
+
 void CreatureAttributes::addLastingEffect(LastingEffect effect, GlobalTime endTime) {
   if (lastingEffects[effect] < endTime)
     lastingEffects[effect] = endTime;
@@ -88,6 +88,7 @@ class CreatureAttributes {
   void addPermanentEffect(LastingEffect, int count);
   void removePermanentEffect(LastingEffect, int count);
   bool considerTimeout(LastingEffect, GlobalTime current);
+  bool hasTimedLastingEffect(GlobalTime) const;
   void addLastingEffect(LastingEffect, GlobalTime endtime);
   optional<GlobalTime> getLastAffected(LastingEffect, GlobalTime currentGlobalTime) const;
   bool canSleep() const;
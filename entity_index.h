@@ -0,0 +1,96 @@
+#pragma once
+
+#include "util.h"
+
+/** An open addressing hash index from entity ids to positions in a dense vector owned by the caller.
+    The caller passes a function that returns the id stored at a given position of the vector.*/
+template <typename Id>
+class EntityIndex {
+  public:
+  template <typename GetId>
+  optional<int> find(const Id& id, GetId getId) const {
+    if (auto slot = findSlot(id, getId))
+      return slots[*slot];
+    return none;
+  }
+
+  /** Indexes the element that was just appended to the vector.*/
+  template <typename GetId>
+  void insert(GetId getId) {
+    ++numElems;
+    if (2 * numElems > slots.size())
+      rebuild(numElems, getId);
+    else
+      place(getId(numElems - 1), numElems - 1);
+  }
+
+  /** Removes an id from the index. If it wasn't the last element, the caller must then call move()
+      for the last element and move it into the freed position.*/
+  template <typename GetId>
+  void erase(const Id& id, GetId getId) {
+    int hole = *findSlot(id, getId);
+    for (int slot = getNext(hole); slots[slot] != empty; slot = getNext(slot)) {
+      int home = getHome(getId(slots[slot]));
+      // An element can fill the hole if its home slot doesn't lie cyclically in (hole, slot].
+      bool canFill = hole < slot ? (home <= hole || home > slot) : (home <= hole && home > slot);
+      if (canFill) {
+        slots[hole] = slots[slot];
+        hole = slot;
+      }
+    }
+    slots[hole] = empty;
+    --numElems;
+  }
+
+  template <typename GetId>
+  void move(const Id& id, int position, GetId getId) {
+    slots[*findSlot(id, getId)] = position;
+  }
+
+  template <typename GetId>
+  void rebuild(int size, GetId getId) {
+    numElems = size;
+    int numSlots = 16;
+    while (numSlots < 2 * numElems)
+      numSlots *= 2;
+    slots = vector<int>(numSlots, empty);
+    for (int i = 0; i < numElems; ++i)
+      place(getId(i), i);
+  }
+
+  void clear() {
+    slots.clear();
+    numElems = 0;
+  }
+
+  private:
+  static const int empty = -1;
+
+  int getHome(const Id& id) const {
+    return id.getHash() & (slots.size() - 1);
+  }
+
+  int getNext(int slot) const {
+    return (slot + 1) & (slots.size() - 1);
+  }
+
+  void place(const Id& id, int position) {
+    int slot = getHome(id);
+    while (slots[slot] != empty)
+      slot = getNext(slot);
+    slots[slot] = position;
+  }
+
+  template <typename GetId>
+  optional<int> findSlot(const Id& id, GetId getId) const {
+    if (slots.empty())
+      return none;
+    for (int slot = getHome(id); slots[slot] != empty; slot = getNext(slot))
+      if (getId(slots[slot]) == id)
+        return slot;
+    return none;
+  }
+
+  vector<int> slots;
+  int numElems = 0;
+};
@@ -8,7 +8,10 @@
 #include "immigrant_info.h"
 #include "cost_info.h"
 #include "time_queue.h"
+#include "visibility_map.h"
+#include "level.h"
 #include "game_time.h"
+#include "model.h"
 
 template <typename Key, typename Value>
 EntityMap<Key, Value>::EntityMap() {
@@ -102,6 +105,7 @@ bool EntityMap<Key, Value>::empty() const {
 template <typename Key, typename Value>
 void EntityMap<Key, Value>::clear() {
   elems.clear();
+  index.clear();
 }
 
 template <typename Key, typename Value>
@@ -111,51 +115,84 @@ int EntityMap<Key, Value>::getSize() const {
 
 template <typename Key, typename Value>
 vector<typename UniqueEntity<Key>::Id> EntityMap<Key, Value>::getKeys() const {
-  return ::getKeys(elems);
+  return elems.transform([](const pair<EntityId, Value>& elem) { return elem.first; });
+}
+
+template <typename Key, typename Value>
+optional<int> EntityMap<Key, Value>::find(EntityId id) const {
+  return index.find(id, [this](int i) -> const EntityId& { return elems[i].first; });
+}
+
+template <typename Key, typename Value>
+int EntityMap<Key, Value>::add(EntityId id, const Value& value) {
+  elems.emplace_back(id, value);
+  index.insert([this](int i) -> const EntityId& { return elems[i].first; });
+  return elems.size() - 1;
 }
 
 template <typename Key, typename Value>
 void EntityMap<Key, Value>::set(EntityId id, const Value& value) {
-  elems[id] = value;
+  if (auto i = find(id))
+    elems[*i].second = value;
+  else
+    add(id, value);
 }
 
 template <typename Key, typename Value>
 void EntityMap<Key, Value>::erase(EntityId id) {
-  elems.erase(id);
+  if (auto i = find(id)) {
+    auto getId = [this](int i) -> const EntityId& { return elems[i].first; };
+    index.erase(id, getId);
+    int last = elems.size() - 1;
+    if (*i != last) {
+      index.move(elems[last].first, *i, getId);
+      elems[*i] = std::move(elems[last]);
+    }
+    elems.pop_back();
+  }
 }
 
 template <typename Key, typename Value>
 const Value& EntityMap<Key, Value>::getOrFail(EntityId id) const {
-  return elems.at(id);
+  auto i = find(id);
+  CHECK(!!i) << "Entity not found in EntityMap";
+  return elems[*i].second;
 }
 
 template <typename Key, typename Value>
 Value& EntityMap<Key, Value>::getOrFail(EntityId id) {
-  return elems.at(id);
+  auto i = find(id);
+  CHECK(!!i) << "Entity not found in EntityMap";
+  return elems[*i].second;
 }
 
 template <typename Key, typename Value>
 Value& EntityMap<Key, Value>::getOrInit(EntityId id) {
-  return elems[id];
+  if (auto i = find(id))
+    return elems[*i].second;
+  else
+    return elems[add(id, Value())].second;
 }
 
 template <typename Key, typename Value>
 optional<Value> EntityMap<Key, Value>::getMaybe(EntityId id) const {
-  return getValueMaybe(elems, id);
+  if (auto i = find(id))
+    return elems[*i].second;
+  else
+    return none;
 }
 
 template <typename Key, typename Value>
 const Value& EntityMap<Key, Value>::getOrElse(EntityId id, const Value& value) const {
-  auto iter = elems.find(id);
-  if (iter != elems.end())
-    return iter->second;
+  if (auto i = find(id))
+    return elems[*i].second;
   else
     return value;
 }
 
 template<typename Key, typename Value>
 bool EntityMap<Key,Value>::hasKey(EntityId key) const {
-  return elems.count(key);
+  return !!find(key);
 }
 
 template <typename Key, typename Value>
@@ -172,21 +209,26 @@ template <typename Key, typename Value>
 template <class Archive> 
 void EntityMap<Key, Value>::serialize(Archive& ar, const unsigned int version) {
   ar(elems);
+  if (Archive::is_loading::value)
+    index.rebuild(elems.size(), [this](int i) -> const EntityId& { return elems[i].first; });
 }
 
 SERIALIZABLE_TMPL(EntityMap, Creature, double);
-SERIALIZABLE_TMPL(EntityMap, Creature, TimeQueue::ExtendedTime);
+SERIALIZABLE_TMPL(EntityMap, Creature, TimeQueue::Node);
 SERIALIZABLE_TMPL(EntityMap, Creature, int);
 SERIALIZABLE_TMPL(EntityMap, Creature, WTask);
 SERIALIZABLE_TMPL(EntityMap, Creature, Collective::CurrentTaskInfo);
 SERIALIZABLE_TMPL(EntityMap, Creature, unordered_map<AttractionType, int, CustomHash<AttractionType>>);
 SERIALIZABLE_TMPL(EntityMap, Creature, vector<Position>);
+SERIALIZABLE_TMPL(EntityMap, Creature, VisibilityMap::VisibleTiles);
 SERIALIZABLE_TMPL(EntityMap, Creature, vector<WItem>);
 SERIALIZABLE_TMPL(EntityMap, Creature, WCreature);
 SERIALIZABLE_TMPL(EntityMap, Creature, pair<GlobalTime, GlobalTime>);
 SERIALIZABLE_TMPL(EntityMap, Creature, ExperienceType);
 SERIALIZABLE_TMPL(EntityMap, Creature, ZoneId);
 SERIALIZABLE_TMPL(EntityMap, Task, LocalTime);
+SERIALIZABLE_TMPL(EntityMap, Creature, LocalTime);
+SERIALIZABLE_TMPL(EntityMap, Creature, vector<Model::EffectChange>);
 SERIALIZABLE_TMPL(EntityMap, Task, WTask);
 SERIALIZABLE_TMPL(EntityMap, Task, MinionTrait);
 SERIALIZABLE_TMPL(EntityMap, Task, Position);
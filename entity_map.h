@@ -17,6 +17,7 @@
 
 #include "unique_entity.h"
 #include "util.h"
+#include "entity_index.h"
 
 template <typename Key, typename Value>
 class EntityMap {
@@ -60,12 +61,15 @@ class EntityMap {
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
-  typedef typename map<EntityId, Value>::const_iterator Iter;
+  typedef typename vector<pair<EntityId, Value>>::const_iterator Iter;
 
   Iter begin() const;
   Iter end() const;
 
   private:
-  map<EntityId, Value> SERIAL(elems);
+  optional<int> find(EntityId) const;
+  int add(EntityId, const Value&);
+  vector<pair<EntityId, Value>> SERIAL(elems);
+  EntityIndex<EntityId> index;
 };
 
@@ -46,52 +46,70 @@ int EntitySet<T>::getSize() const {
 
 template <class T>
 void EntitySet<T>::insert(const T* e) {
-  elems.insert(e->getUniqueId());
+  insert(e->getUniqueId());
 }
 
 template <class T>
 void EntitySet<T>::erase(const T* e) {
-  elems.erase(e->getUniqueId());
+  erase(e->getUniqueId());
 }
 
 template <class T>
 bool EntitySet<T>::contains(const T* e) const {
-  return elems.count(e->getUniqueId());
+  return contains(e->getUniqueId());
 }
 
 template <class T>
 void EntitySet<T>::insert(WeakPointer<const T> e) {
-  elems.insert(e->getUniqueId());
+  insert(e->getUniqueId());
 }
 
 template <class T>
 void EntitySet<T>::erase(WeakPointer<const T> e) {
-  elems.erase(e->getUniqueId());
+  erase(e->getUniqueId());
 }
 
 template <class T>
 bool EntitySet<T>::contains(WeakPointer<const T> e) const {
-  return elems.count(e->getUniqueId());
+  return contains(e->getUniqueId());
+}
+
+template <class T>
+optional<int> EntitySet<T>::find(typename UniqueEntity<T>::Id e) const {
+  return index.find(e, [this](int i) -> const typename UniqueEntity<T>::Id& { return elems[i]; });
 }
 
 template <class T>
 void EntitySet<T>::insert(typename UniqueEntity<T>::Id e) {
-  elems.insert(e);
+  if (!find(e)) {
+    elems.push_back(e);
+    index.insert([this](int i) -> const typename UniqueEntity<T>::Id& { return elems[i]; });
+  }
 }
 
 template <class T>
 void EntitySet<T>::clear() {
   elems.clear();
+  index.clear();
 }
 
 template <class T>
 void EntitySet<T>::erase(typename UniqueEntity<T>::Id e) {
-  elems.erase(e);
+  if (auto i = find(e)) {
+    auto getId = [this](int i) -> const typename UniqueEntity<T>::Id& { return elems[i]; };
+    index.erase(e, getId);
+    int last = elems.size() - 1;
+    if (*i != last) {
+      index.move(elems[last], *i, getId);
+      elems[*i] = elems[last];
+    }
+    elems.pop_back();
+  }
 }
 
 template <class T>
 bool EntitySet<T>::contains(typename UniqueEntity<T>::Id e) const {
-  return elems.count(e);
+  return !!find(e);
 }
 
 template <class T>
@@ -110,7 +128,12 @@ ItemPredicate EntitySet<Item>::containsPredicate() const {
 }
 
 template <class T>
-SERIALIZE_TMPL(EntitySet<T>, elems)
+template <class Archive>
+void EntitySet<T>::serialize(Archive& ar, const unsigned int version) {
+  ar(elems);
+  if (Archive::is_loading::value)
+    index.rebuild(elems.size(), [this](int i) -> const typename UniqueEntity<T>::Id& { return elems[i]; });
+}
 
 SERIALIZABLE_TMPL(EntitySet, Item);
 SERIALIZABLE_TMPL(EntitySet, Task);
@@ -17,6 +17,7 @@
 
 #include "unique_entity.h"
 #include "util.h"
+#include "entity_index.h"
 
 template <typename T>
 class EntitySet {
@@ -44,16 +45,22 @@ class EntitySet {
 
   ItemPredicate containsPredicate() const;
 
-  typedef typename set<typename UniqueEntity<T>::Id>::const_iterator Iter;
+  typedef typename vector<typename UniqueEntity<T>::Id>::const_iterator Iter;
 
   Iter begin() const;
   Iter end() const;
 
   size_t getHash() const {
-    return combineHashIter(elems.begin(), elems.end());
+    // Iteration order depends on the order of insertion, so combine the hashes in an order-independent way.
+    size_t ret = 0;
+    for (auto& id : elems)
+      ret += combineHash(id);
+    return ret;
   }
 
   private:
-  set<typename UniqueEntity<T>::Id> SERIAL(elems);
+  optional<int> find(typename UniqueEntity<T>::Id) const;
+  vector<typename UniqueEntity<T>::Id> SERIAL(elems);
+  EntityIndex<typename UniqueEntity<T>::Id> index;
 };
 
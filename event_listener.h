@@ -99,7 +99,7 @@ namespace EventInfo {
   };
 
   struct VisibilityChanged {
-    Position pos;
+    vector<Position> positions;
   };
 
   class GameEvent : public variant<CreatureMoved, CreatureKilled, ItemsPickedUp, ItemsDropped, ItemsAppeared, Projectile,
@@ -62,8 +62,37 @@ void FieldOfView::squareChanged(Vec2 pos) {
     }
 }
 
-void FieldOfView::Visibility::setVisible(WConstLevel level, int x, int y) {
-  if (level->inBounds(Vec2(px + x, py + y)) &&
+void FieldOfView::precompute(const vector<Vec2>& positions) {
+  const int minPositions = 8;
+  vector<Vec2> missing;
+  for (Vec2 v : positions)
+    if (!visibility[v])
+      missing.push_back(v);
+  int numThreads = min<int>(missing.size() / minPositions, thread::hardware_concurrency());
+  if (numThreads < 2)
+    return;
+  Rectangle bounds = Rectangle::boundingBox(missing).minusMargin(-sightRange).intersection(level->getBounds());
+  Table<bool> blocking(bounds);
+  for (Vec2 v : bounds)
+    blocking[v] = !Position(v, level).canSeeThru(vision);
+  vector<unique_ptr<Visibility>> results(missing.size());
+  std::atomic<int> next(0);
+  auto work = [&] {
+    for (int i = next++; i < missing.size(); i = next++)
+      results[i].reset(new Visibility(blocking, missing[i].x, missing[i].y));
+  };
+  vector<thread> threads;
+  for (int i = 1; i < numThreads; ++i)
+    threads.emplace_back(work);
+  work();
+  for (auto& t : threads)
+    t.join();
+  for (int i : All(missing))
+    visibility[missing[i]] = std::move(results[i]);
+}
+
+void FieldOfView::Visibility::setVisible(const Rectangle& bounds, int x, int y) {
+  if (Vec2(px + x, py + y).inRectangle(bounds) &&
       !visible[x + sightRange][y + sightRange] && x * x + y * y <= sightRange * sightRange) {
     visible[x + sightRange][y + sightRange] = 1;
     visibleTiles.push_back(Vec2(px + x, py + y));
@@ -73,21 +102,31 @@ void FieldOfView::Visibility::setVisible(WConstLevel level, int x, int y) {
 static int totalIter = 0;
 static int numSamples = 0;
 
-FieldOfView::Visibility::Visibility(WLevel level, VisionId vision, int x, int y) : px(x), py(y) {
+FieldOfView::Visibility::Visibility(WLevel level, VisionId vision, int x, int y)
+    : Visibility(level->getBounds(), [&](Vec2 v) { return !Position(v, level).canSeeThru(vision); }, x, y) {
+}
+
+FieldOfView::Visibility::Visibility(const Table<bool>& blocking, int x, int y)
+    : Visibility(blocking.getBounds(), [&](Vec2 v) { return !v.inRectangle(blocking.getBounds()) || blocking[v]; },
+        x, y) {
+}
+
+FieldOfView::Visibility::Visibility(Rectangle bounds, function<bool (Vec2)> isBlocking, int x, int y)
+    : px(x), py(y) {
   memset(visible, 0, (2 * sightRange + 1) * (2 * sightRange + 1));
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !Position(Vec2(x + px, y + py), level).canSeeThru(vision); },
-      [&](int px, int py) { setVisible(level, px, py); });
+      [&](int px, int py) { return isBlocking(Vec2(x + px, y + py)); },
+      [&](int px, int py) { setVisible(bounds, px, py); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !Position(Vec2(x + py, y - px), level).canSeeThru(vision); },
-      [&](int px, int py) { setVisible(level, py, -px); });
+      [&](int px, int py) { return isBlocking(Vec2(x + py, y - px)); },
+      [&](int px, int py) { setVisible(bounds, py, -px); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !Position(Vec2(x - px, y - py), level).canSeeThru(vision); },
-      [&](int px, int py) { setVisible(level, -px, -py); });
+      [&](int px, int py) { return isBlocking(Vec2(x - px, y - py)); },
+      [&](int px, int py) { setVisible(bounds, -px, -py); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !Position(Vec2(x - py, y + px), level).canSeeThru(vision); },
-      [&](int px, int py) { setVisible(level, -py, px); });
-  setVisible(level, 0, 0);
+      [&](int px, int py) { return isBlocking(Vec2(x - py, y + px)); },
+      [&](int px, int py) { setVisible(bounds, -py, px); });
+  setVisible(bounds, 0, 0);
 /*  ++numSamples;
   totalIter += visibleTiles.size();
   if (numSamples%100 == 0)
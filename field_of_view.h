@@ -27,6 +27,10 @@ class FieldOfView {
   const vector<Vec2>& getVisibleTiles(Vec2 from);
   void squareChanged(Vec2 pos);
 
+  /** Calculates the missing visibility data for the given positions on worker threads, using a snapshot
+      of the vision-blocking squares. Does nothing if only a few positions are missing.*/
+  void precompute(const vector<Vec2>& positions);
+
   SERIALIZATION_DECL(FieldOfView)
 
   const static int sightRange = 30;
@@ -41,18 +45,20 @@ class FieldOfView {
     const vector<Vec2>& getVisibleTiles() const;
 
     Visibility(WLevel, VisionId, int x, int y);
+    Visibility(const Table<bool>& blocking, int x, int y);
     Visibility(Visibility&&) = default;
     Visibility& operator = (Visibility&&) = default;
 
     SERIALIZATION_DECL(Visibility)
 
     private:
+    Visibility(Rectangle bounds, function<bool (Vec2)> isBlocking, int x, int y);
     char SERIAL(visible)[sightRange * 2 + 1][sightRange * 2 + 1];
     vector<Vec2> SERIAL(visibleTiles);
     void calculate(int,int,int,int, int, int, int, int,
         function<bool (int, int)> isBlocking,
         function<void (int, int)> setVisible);
-    void setVisible(WConstLevel, int, int);
+    void setVisible(const Rectangle& bounds, int, int);
 
     int SERIAL(px);
     int SERIAL(py);
@@ -71,7 +71,6 @@ Game::Game(Table<PModel>&& m, Vec2 basePos, const CampaignSetup& c)
           playerCollective = c;
         }
       }
-      m->updateSunlightMovement();
     }
   turnEvents = {0, 10, 50, 100, 300, 500};
   for (int i : Range(200))
@@ -299,13 +298,10 @@ void Game::tick(GlobalTime time) {
   }
   auto previous = sunlightInfo.getState();
   sunlightInfo.update(GlobalTime((int) currentTime));
-  if (previous != sunlightInfo.getState())
-    for (Vec2 v : models.getBounds())
-      if (WModel m = models[v].get()) {
-        m->updateSunlightMovement();
-        if (playerControl)
-          playerControl->onSunlightVisibilityChanged();
-      }
+  // Movement sectors don't need updating here, since creatures that burn in sunlight get a different
+  // MovementType during the day, which has its own sectors.
+  if (previous != sunlightInfo.getState() && playerControl)
+    playerControl->onSunlightVisibilityChanged();
   INFO << "Global time " << time;
   for (WCollective col : collectives) {
     if (isVillainActive(col))
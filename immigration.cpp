@@ -329,7 +329,7 @@ static vector<Position> pickSpawnPositions(const vector<WCreature>& creatures, v
 vector<Position> Immigration::Available::getSpawnPositions() const {
   vector<Position> positions = getInfo().getSpawnLocation().match(
     [&] (FurnitureType type) {
-      return asVector<Position>(immigration->collective->getConstructions().getBuiltPositions(type));
+      return immigration->collective->getConstructions().getBuiltPositions(type).getElems();
     },
     [&] (OutsideTerritory) {
       auto ret = immigration->collective->getTerritory().getExtended(10, 20);
@@ -45,13 +45,20 @@ void Level::serialize(Archive& ar, const unsigned int version) {
   ar(name, sunlight, bucketMap, sectors, lightAmount, unavailable);
   ar(levelId, noDiagonalPassing, lightCapAmount, creatureIds, memoryUpdates);
   ar(furniture, tickingFurniture, covered);
+  if (Archive::is_loading::value) {
+    tileFlags = TileFlags(squares->getBounds());
+    for (Vec2 pos : squares->getBounds())
+      updateTileFlags(pos);
+  }
 }  
 
 SERIALIZABLE(Level);
 
 SERIALIZATION_CONSTRUCTOR_IMPL(Level);
 
-Level::~Level() {}
+Level::~Level() {
+  releaseCacheIndex();
+}
 
 Level::Level(Private, SquareArray s, FurnitureArray f, WModel m, const string& n,
     Table<double> sun, LevelId id, Table<bool> cover)
@@ -59,12 +66,14 @@ Level::Level(Private, SquareArray s, FurnitureArray f, WModel m, const string& n
       memoryUpdates(squares->getBounds(), true), model(m),
       name(n), sunlight(sun), covered(cover), bucketMap(squares->getBounds().width(), squares->getBounds().height(),
       FieldOfView::sightRange), lightAmount(squares->getBounds(), 0), lightCapAmount(squares->getBounds(), 1),
-      levelId(id) {
+      tileFlags(squares->getBounds()), levelId(id) {
 }
 
 PLevel Level::create(SquareArray s, FurnitureArray f, WModel m, const string& n,
     Table<double> sun, LevelId id, Table<bool> cover) {
   auto ret = makeOwner<Level>(Private{}, std::move(s), std::move(f), m, n, sun, id, cover);
+  for (Vec2 pos : ret->squares->getBounds())
+    ret->updateTileFlags(pos);
   for (Vec2 pos : ret->squares->getBounds()) {
     auto square = ret->squares->getReadonly(pos);
     square->onAddedToLevel(Position(pos, ret.get()));
@@ -86,6 +95,69 @@ LevelId Level::getUniqueId() const {
   return levelId;
 }
 
+namespace {
+struct CacheIndexes {
+  // Levels can be created on the loading thread while the game is running. Lookups don't take the mutex,
+  // so the table entries are atomic, and an index is only reused with a new generation.
+  std::mutex mutex;
+  vector<int> released;
+  int numUsed = 0;
+  atomic<Level*> levels[Level::maxCacheIndex] = {};
+  atomic<uint32_t> generations[Level::maxCacheIndex] = {};
+};
+}
+
+static CacheIndexes& getCacheIndexes() {
+  static CacheIndexes ret;
+  return ret;
+}
+
+int Level::getNewCacheIndex(Level* level) {
+  auto& indexes = getCacheIndexes();
+  std::lock_guard<std::mutex> lock(indexes.mutex);
+  int ret;
+  if (!indexes.released.empty()) {
+    ret = indexes.released.back();
+    indexes.released.pop_back();
+  } else {
+    CHECK(indexes.numUsed < maxCacheIndex) << "Too many levels in memory";
+    ret = indexes.numUsed++;
+  }
+  indexes.levels[ret] = level;
+  return ret;
+}
+
+uint32_t Level::getCurrentGeneration(int index) {
+  return getCacheIndexes().generations[index];
+}
+
+int Level::getCacheIndex() const {
+  return cacheIndex;
+}
+
+uint32_t Level::getCacheGeneration() const {
+  return cacheGeneration;
+}
+
+WLevel Level::getByCacheIndex(int index, uint32_t generation) {
+  auto& indexes = getCacheIndexes();
+  // The generation is increased before the index is given to another level, so reading it after the level
+  // pointer rejects a level that replaced ours in the meantime.
+  Level* level = indexes.levels[index];
+  if (level && indexes.generations[index] == generation)
+    return level;
+  else
+    return nullptr;
+}
+
+void Level::releaseCacheIndex() {
+  auto& indexes = getCacheIndexes();
+  std::lock_guard<std::mutex> lock(indexes.mutex);
+  indexes.levels[cacheIndex] = nullptr;
+  ++indexes.generations[cacheIndex];
+  indexes.released.push_back(cacheIndex);
+}
+
 Rectangle Level::getMaxBounds() {
   return Rectangle(360, 360);
 }
@@ -163,7 +235,18 @@ void Level::updateVisibility(Vec2 changedSquare) {
         addDarknessSource(pos, darknessRadius, 1);
   }
   for (Vec2 pos : getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL))
-    getModel()->addEvent(EventInfo::VisibilityChanged{Position(pos, this)});
+    changedVisibility.insert(pos);
+}
+
+void Level::sendVisibilityChangedEvent() {
+  if (!changedVisibility.empty()) {
+    vector<Position> positions;
+    positions.reserve(changedVisibility.size());
+    for (Vec2 pos : changedVisibility)
+      positions.push_back(Position(pos, this));
+    changedVisibility.clear();
+    getModel()->addEvent(EventInfo::VisibilityChanged{std::move(positions)});
+  }
 }
 
 vector<WCreature> Level::getPlayers() const {
@@ -382,6 +465,55 @@ vector<WCreature> Level::getAllCreatures(Rectangle bounds) const {
   return bucketMap->getElements(bounds);
 }
 
+void Level::getClosestCreatures(Vec2 pos, int maxDist, int maxCount, function<bool(WCreature)> predicate,
+    vector<WCreature>& result) const {
+  bucketMap->getClosest(pos, maxDist, maxCount, std::move(predicate), result);
+}
+
+WCreature Level::getClosestCreature(Vec2 pos, int maxDist, function<bool(WCreature)> predicate) const {
+  return bucketMap->getClosest(pos, maxDist, std::move(predicate));
+}
+
+const PositionSet& Level::getItemPositions(ItemIndex index) const {
+  auto& positions = itemPositions[index];
+  if (!positions) {
+    positions = PositionSet();
+    for (Vec2 v : getBounds()) {
+      Position pos(v, getThis().removeConst());
+      if (!pos.getItems(index).empty())
+        positions->insert(pos);
+    }
+  }
+  return *positions;
+}
+
+void Level::onItemsChanged(Vec2 v) {
+  static const int maxItemChanges = 1000;
+  itemChanges.push_back(v);
+  if (itemChanges.size() > 2 * maxItemChanges) {
+    itemChanges = vector<Vec2>(itemChanges.begin() + maxItemChanges, itemChanges.end());
+    itemChangesStart += maxItemChanges;
+  }
+  Position pos(v, this);
+  for (auto index : ENUM_ALL(ItemIndex))
+    if (auto& positions = itemPositions[index]) {
+      if (pos.getItems(index).empty())
+        positions->erase(pos);
+      else
+        positions->insert(pos);
+    }
+}
+
+int Level::getItemsVersion() const {
+  return itemChangesStart + itemChanges.size();
+}
+
+optional<vector<Vec2>> Level::getItemChanges(int sinceVersion) const {
+  if (sinceVersion < itemChangesStart)
+    return none;
+  return vector<Vec2>(itemChanges.begin() + sinceVersion - itemChangesStart, itemChanges.end());
+}
+
 bool Level::containsCreature(UniqueEntity<Creature>::Id id) const {
   return creatureIds.contains(id);
 }
@@ -398,6 +530,15 @@ bool Level::canSee(Vec2 from, Vec2 to, const Vision& vision) const {
   return isWithinVision(from, to, vision) && getFieldOfView(vision.getId()).canSee(from, to);
 }
 
+void Level::precomputeFieldOfView(const vector<WCreature>& creatures) {
+  EnumMap<VisionId, vector<Vec2>> positions;
+  for (WCreature c : creatures)
+    positions[c->getVision().getId()].push_back(c->getPosition().getCoord());
+  for (VisionId vision : ENUM_ALL(VisionId))
+    if (!positions[vision].empty())
+      getFieldOfView(vision).precompute(positions[vision]);
+}
+
 bool Level::canSee(WConstCreature c, Vec2 pos) const {
   return canSee(c->getPosition().getCoord(), pos, c->getVision());
 }
@@ -470,6 +611,7 @@ void Level::addTickingFurniture(Vec2 pos) {
 }
 
 void Level::tick() {
+  sendVisibilityChangedEvent();
   for (Vec2 pos : tickingSquares)
     squares->getWritable(pos)->tick(Position(pos, this));
   for (Vec2 pos : tickingFurniture)
@@ -494,6 +636,24 @@ bool Level::areConnected(Vec2 p1, Vec2 p2, const MovementType& movement) const {
   return inBounds(p1) && inBounds(p2) && getSectors(movement).same(p1, p2);
 }
 
+int Level::getSectorId(Vec2 pos, const MovementType& movement) const {
+  return inBounds(pos) ? getSectors(movement).getSector(pos) : -1;
+}
+
+int Level::getSectorsVersion(const MovementType& movement) const {
+  return getSectors(movement).getVersion();
+}
+
+int Level::getTerrainVersion() const {
+  return terrainChangesStart + terrainChanges.size();
+}
+
+optional<vector<Vec2>> Level::getTerrainChanges(int sinceVersion) const {
+  if (sinceVersion < terrainChangesStart)
+    return none;
+  return vector<Vec2>(terrainChanges.begin() + sinceVersion - terrainChangesStart, terrainChanges.end());
+}
+
 Sectors& Level::getSectors(const MovementType& movement) const {
   if (!sectors.count(movement)) {
     sectors[movement] = Sectors(getBounds());
@@ -509,10 +669,6 @@ bool Level::isChokePoint(Vec2 pos, const MovementType& movement) const {
   return getSectors(movement).isChokePoint(pos);
 }
 
-void Level::updateSunlightMovement() {
-  sectors.clear();
-}
-
 int Level::getNumGeneratedSquares() const {
   return squares->getNumGenerated();
 }
@@ -543,6 +699,22 @@ bool Level::isUnavailable(Vec2 pos) const {
   return unavailable[pos];
 }
 
+void Level::updateTileFlags(Vec2 pos) {
+  vector<WConstFurniture> f;
+  for (auto layer : ENUM_ALL(FurnitureLayer))
+    if (auto elem = furniture->getBuilt(layer).getReadonly(pos))
+      f.push_back(elem);
+  auto square = squares->getReadonly(pos);
+  if (tileFlags.update(pos, f, covered[pos], square->isOnFire(), !!square->getForbiddenTribe())) {
+    static const int maxTerrainChanges = 1000;
+    terrainChanges.push_back(pos);
+    if (terrainChanges.size() > 2 * maxTerrainChanges) {
+      terrainChanges = vector<Vec2>(terrainChanges.begin() + maxTerrainChanges, terrainChanges.end());
+      terrainChangesStart += maxTerrainChanges;
+    }
+  }
+}
+
 void Level::setFurniture(Vec2 pos, PFurniture f) {
   auto layer = f->getLayer();
   furniture->getConstruction(pos, layer).reset();
@@ -24,6 +24,9 @@
 #include "entity_set.h"
 #include "vision_id.h"
 #include "furniture_layer.h"
+#include "item_index.h"
+#include "position_set.h"
+#include "tile_flags.h"
 
 class Model;
 class Square;
@@ -91,7 +94,8 @@ class Level : public OwnedObject<Level> {
   void removeCreature(WCreature);
 
   /** Recalculates visibility data assuming that \paramname{changedSquare} has changed
-      its obstructing/non-obstructing attribute. */
+      its obstructing/non-obstructing attribute. The affected squares are reported in one
+      batched VisibilityChanged event on the next tick. */
   void updateVisibility(Vec2 changedSquare);
 
   /** Checks \paramname{pos} lies within the level's boundaries.*/
@@ -132,14 +136,35 @@ class Level : public OwnedObject<Level> {
   vector<WCreature> getAllCreatures(Rectangle bounds) const;
   //@}
 
+  //@{
+  /** Returns the creatures within maxDist that satisfy the predicate, closest first. Nearby creatures are
+      visited first, so the search stops early when there are many creatures on the level.*/
+  void getClosestCreatures(Vec2, int maxDist, int maxCount, function<bool(WCreature)>,
+      vector<WCreature>& result) const;
+  WCreature getClosestCreature(Vec2, int maxDist, function<bool(WCreature)>) const;
+  //@}
+
   bool containsCreature(UniqueEntity<Creature>::Id) const;
 
+  /** Returns the positions that hold items of the given index. The set is built on first use and
+      then kept up to date by onItemsChanged().*/
+  const PositionSet& getItemPositions(ItemIndex) const;
+  void onItemsChanged(Vec2);
+  /** Increased whenever the items on a tile change.*/
+  int getItemsVersion() const;
+  /** Returns the tiles whose items changed since the given items version, possibly with repetitions.
+      Only the most recent changes are kept, so returns none if some of them are no longer available.*/
+  optional<vector<Vec2>> getItemChanges(int sinceVersion) const;
+
   /** Checks whether the creature can see the square.*/
   bool canSee(WConstCreature c, Vec2 to) const;
 
   /** Returns if it's possible to see the given square.*/
   bool canSee(Vec2 from, Vec2 to, const Vision&) const;
 
+  /** Fills the field of view of the given creatures ahead of their moves.*/
+  void precomputeFieldOfView(const vector<WCreature>&);
+
   /** Returns all tiles visible by a creature.*/
   vector<Vec2> getVisibleTiles(Vec2 pos, const Vision&) const;
 
@@ -161,11 +186,18 @@ class Level : public OwnedObject<Level> {
 
   /** Returns if two squares are connected assuming given movement.*/
   bool areConnected(Vec2, Vec2, const MovementType&) const;
+  /** Returns the id of the connected area containing the tile, or -1 if it's not navigable or out of bounds.
+      The ids are only valid as long as getSectorsVersion() doesn't change.*/
+  int getSectorId(Vec2, const MovementType&) const;
+  int getSectorsVersion(const MovementType&) const;
+  /** Increased whenever the movement or vision flags of a tile change.*/
+  int getTerrainVersion() const;
+  /** Returns the tiles whose flags changed since the given terrain version, possibly with repetitions.
+      Only the most recent changes are kept, so returns none if some of them are no longer available.*/
+  optional<vector<Vec2>> getTerrainChanges(int sinceVersion) const;
 
   bool isChokePoint(Vec2, const MovementType&) const;
 
-  void updateSunlightMovement();
-
   int getNumGeneratedSquares() const;
   int getNumTotalSquares() const;
   bool isUnavailable(Vec2) const;
@@ -176,6 +208,15 @@ class Level : public OwnedObject<Level> {
   void setNeedsRenderUpdate(Vec2, bool);
 
   LevelId getUniqueId() const;
+  /** Returns a small number that is unique among all levels in memory, for indexing per-level caches.
+      It's not serialized, and it's reused after the level is destroyed.*/
+  int getCacheIndex() const;
+  /** Increased every time the cache index is reused, so the pair identifies the level even after it's destroyed.*/
+  uint32_t getCacheGeneration() const;
+  /** Returns the level with the given cache index and generation, or nullptr if it's no longer in memory.
+      It doesn't lock, so it can be called from any thread.*/
+  static WLevel getByCacheIndex(int index, uint32_t generation);
+  static constexpr int maxCacheIndex = 1 << 14;
   void setFurniture(Vec2, PFurniture);
 
   SERIALIZATION_DECL(Level)
@@ -193,11 +234,14 @@ class Level : public OwnedObject<Level> {
   unordered_map<StairKey, vector<Position>> SERIAL(landingSquares);
   set<Vec2> SERIAL(tickingSquares);
   set<Vec2> SERIAL(tickingFurniture);
+  set<Vec2> changedVisibility;
+  void sendVisibilityChangedEvent();
   void eraseCreature(WCreature, Vec2 coord);
   void placeCreature(WCreature, Vec2 pos);
   void unplaceCreature(WCreature, Vec2 pos);
   vector<WCreature> SERIAL(creatures);
   EntitySet<Creature> SERIAL(creatureIds);
+  mutable EnumMap<ItemIndex, optional<PositionSet>> itemPositions;
   WModel SERIAL(model) = nullptr;
   mutable HeapAllocated<EnumMap<VisionId, FieldOfView>> SERIAL(fieldOfView);
   string SERIAL(name);
@@ -208,6 +252,13 @@ class Level : public OwnedObject<Level> {
   Table<double> SERIAL(lightCapAmount);
   mutable unordered_map<MovementType, Sectors> SERIAL(sectors);
   Sectors& getSectors(const MovementType&) const;
+  /** Not serialized, rebuilt after creation and loading.*/
+  TileFlags tileFlags;
+  void updateTileFlags(Vec2);
+  vector<Vec2> terrainChanges;
+  int terrainChangesStart = 0;
+  vector<Vec2> itemChanges;
+  int itemChangesStart = 0;
   
   friend class LevelBuilder;
   struct Private {};
@@ -225,5 +276,10 @@ class Level : public OwnedObject<Level> {
   bool isWithinVision(Vec2 from, Vec2 to, const Vision&) const;
   LevelId SERIAL(levelId) = 0;
   bool SERIAL(noDiagonalPassing) = false;
+  static int getNewCacheIndex(Level*);
+  static uint32_t getCurrentGeneration(int cacheIndex);
+  void releaseCacheIndex();
+  int cacheIndex = getNewCacheIndex(this);
+  uint32_t cacheGeneration = getCurrentGeneration(cacheIndex);
 };
 
@@ -132,6 +132,41 @@ bool MinionEquipment::isOwner(WConstItem it, WConstCreature c) const {
 
 const static vector<WItem> emptyItems;
 
+void MinionEquipment::removeDestroyedItems(WConstCreature c) {
+  if (!myItems.hasKey(c))
+    return;
+  auto& items = myItems.getOrFail(c);
+  auto remaining = items.filter([](WItem item) { return !!item; });
+  if (remaining.size() == items.size())
+    return;
+  items = remaining;
+  // The ids of destroyed items are only known to the owners map, so look for entries of this creature that
+  // don't belong to any of its remaining items.
+  auto remainingIds = remaining.transform([](WItem item) { return item->getUniqueId(); });
+  vector<UniqueEntity<Item>::Id> destroyed;
+  for (auto& elem : owners)
+    if (elem.second == c->getUniqueId() && !remainingIds.contains(elem.first))
+      destroyed.push_back(elem.first);
+  for (auto id : destroyed) {
+    owners.erase(id);
+    locked.erase(make_pair(c->getUniqueId(), id));
+  }
+}
+
+void MinionEquipment::removeOwner(WConstCreature c) {
+  removeDestroyedItems(c);
+  for (auto item : getItemsOwnedBy(c))
+    discard(item);
+  myItems.erase(c);
+}
+
+void MinionEquipment::updateOwner(WConstCreature c) {
+  removeDestroyedItems(c);
+  for (auto item : getItemsOwnedBy(c))
+    if (!needsItem(c, item))
+      discard(item);
+}
+
 void MinionEquipment::updateOwners(const vector<WCreature>& creatures) {
   auto oldItemMap = myItems;
   myItems.clear();
@@ -159,6 +194,41 @@ void MinionEquipment::updateItems(const vector<WItem>& items) {
     }
 }
 
+void MinionEquipment::removeLostItems(const vector<WCreature>& creatures,
+    function<vector<WItem>()> getCollectiveItems) {
+  vector<WItem> notCarried;
+  for (auto c : creatures) {
+    removeDestroyedItems(c);
+    for (auto item : getItemsOwnedBy(c))
+      if (!c->getEquipment().hasItem(item))
+        notCarried.push_back(item);
+  }
+  if (notCarried.empty())
+    return;
+  EntitySet<Item> collectiveItems(getCollectiveItems());
+  for (auto item : notCarried)
+    if (!collectiveItems.contains(item))
+      discard(item);
+}
+
+int MinionEquipment::countOutdatedOwners(const vector<WCreature>& creatures, const vector<WItem>& items) const {
+  MinionEquipment rebuilt(*this);
+  rebuilt.updateOwners(creatures);
+  rebuilt.updateItems(items);
+  int ret = 0;
+  for (auto item : items)
+    if (getOwner(item) != rebuilt.getOwner(item))
+      ++ret;
+  // Items that are no longer in the list are dropped from the rebuilt copy, but not from the live ownership.
+  EntitySet<Item> listed;
+  for (auto item : items)
+    listed.insert(item);
+  for (auto& elem : owners)
+    if (!listed.contains(elem.first) && !rebuilt.owners.hasKey(elem.first))
+      ++ret;
+  return ret;
+}
+
 vector<WItem> MinionEquipment::getItemsOwnedBy(WConstCreature c, ItemPredicate predicate) const {
   vector<WItem> ret;
   for (auto& item : myItems.getOrElse(c, emptyItems))
@@ -187,13 +257,23 @@ void MinionEquipment::discard(UniqueEntity<Item>::Id id) {
 }
 
 void MinionEquipment::sortByEquipmentValue(WConstCreature c, vector<WItem>& items) const {
-  sort(items.begin(), items.end(), [this, c](WConstItem it1, WConstItem it2) {
-      int diff = getItemValue(c, it1) - getItemValue(c, it2);
-      if (diff == 0)
-        return it1->getUniqueId() < it2->getUniqueId();
-      else
-        return diff > 0;
-    });
+  auto ids = items.transform([](WConstItem it) { return it->getUniqueId(); });
+  auto& cached = sortedCache[getAttrSignature(c)];
+  if (cached.items != ids) {
+    vector<int> values = items.transform([this, c](WConstItem it) { return getItemValue(c, it); });
+    cached.items = ids;
+    cached.order.clear();
+    for (int i : All(items))
+      cached.order.push_back(i);
+    sort(cached.order.begin(), cached.order.end(), [&](int i1, int i2) {
+        int diff = values[i1] - values[i2];
+        if (diff == 0)
+          return ids[i1] < ids[i2];
+        else
+          return diff > 0;
+      });
+  }
+  items = cached.order.transform([&](int i) { return items[i]; });
 }
 
 bool MinionEquipment::tryToOwn(WConstCreature c, WItem it) {
@@ -260,7 +340,32 @@ void MinionEquipment::autoAssign(WConstCreature creature, vector<WItem> possible
   }
 }
 
+bool MinionEquipment::ValueKey::operator == (const ValueKey& o) const {
+  return item == o.item && attr == o.attr;
+}
+
+int MinionEquipment::ValueKey::getHash() const {
+  return combineHash(item, attr.first, attr.second);
+}
+
+MinionEquipment::AttrSignature MinionEquipment::getAttrSignature(WConstCreature c) {
+  return {c->getAttributes().getRawAttr(AttrType::DAMAGE), c->getAttributes().getRawAttr(AttrType::SPELL_DAMAGE)};
+}
+
+void MinionEquipment::clearCache() {
+  valueCache.clear();
+  sortedCache.clear();
+}
+
 int MinionEquipment::getItemValue(WConstCreature c, WConstItem it) const {
+  ValueKey key {it->getUniqueId(), getAttrSignature(c)};
+  auto cached = valueCache.find(key);
+  if (cached != valueCache.end())
+    return cached->second;
+  return valueCache[key] = computeItemValue(c, it);
+}
+
+int MinionEquipment::computeItemValue(WConstCreature c, WConstItem it) {
   int sum = 0;
   for (auto attr : ENUM_ALL(AttrType))
     switch (attr) {
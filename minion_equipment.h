@@ -32,6 +32,10 @@ class MinionEquipment {
   bool tryToOwn(WConstCreature, WItem);
   void discard(WConstItem);
   void discard(UniqueEntity<Item>::Id);
+  /** Drops the ownership of all items of a creature that left the collective.*/
+  void removeOwner(WConstCreature);
+  /** Discards the items that the creature no longer needs.*/
+  void updateOwner(WConstCreature);
   void updateOwners(const vector<WCreature>&);
   vector<WItem> getItemsOwnedBy(WConstCreature, ItemPredicate = nullptr) const;
 
@@ -43,6 +47,16 @@ class MinionEquipment {
   void sortByEquipmentValue(WConstCreature, vector<WItem>& items) const;
   void autoAssign(WConstCreature, vector<WItem> possibleItems);
   void updateItems(const vector<WItem>& items);
+  /** Drops the ownership of items that their owners don't carry and that aren't among the collective's items
+      anymore, e.g. thrown ones. The collective's items are only listed if some owned item isn't carried.*/
+  void removeLostItems(const vector<WCreature>&, function<vector<WItem>()> getCollectiveItems);
+  /** Item values only depend on the item and on the creature's damage attributes, so they are cached, together
+      with the sorted lists of candidate items, until this is called. The collective calls it every turn.*/
+  void clearCache();
+  /** Rebuilds a copy of the ownership from the creatures and all items they could own, and returns the number of
+      items whose owner differs. Ownership is kept up to date incrementally and by removeLostItems(), so this is only
+      a consistency check.*/
+  int countOutdatedOwners(const vector<WCreature>&, const vector<WItem>& items) const;
 
   private:
   enum EquipmentType { ARMOR, HEALING, COMBAT_ITEM };
@@ -50,7 +64,23 @@ class MinionEquipment {
   static optional<EquipmentType> getEquipmentType(WConstItem it);
   optional<int> getEquipmentLimit(EquipmentType type) const;
   WItem getWorstItem(WConstCreature, vector<WItem>) const;
+  void removeDestroyedItems(WConstCreature);
   int getItemValue(WConstCreature, WConstItem) const;
+  static int computeItemValue(WConstCreature, WConstItem);
+  typedef pair<double, double> AttrSignature;
+  static AttrSignature getAttrSignature(WConstCreature);
+  struct ValueKey {
+    UniqueEntity<Item>::Id item;
+    AttrSignature attr;
+    bool operator == (const ValueKey&) const;
+    int getHash() const;
+  };
+  mutable unordered_map<ValueKey, int, CustomHash<ValueKey>> valueCache;
+  struct SortedItems {
+    vector<UniqueEntity<Item>::Id> items;
+    vector<int> order;
+  };
+  mutable map<AttrSignature, SortedItems> sortedCache;
 
   EntityMap<Item, UniqueEntity<Creature>::Id> SERIAL(owners);
   EntityMap<Creature, vector<WItem>> SERIAL(myItems);
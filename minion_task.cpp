@@ -129,11 +129,12 @@ vector<Position> MinionTasks::getAllPositions(WConstCollective collective, WCons
   for (auto furnitureType : getAllFurniture(task))
     if (info.furniturePredicate(collective, c, furnitureType) &&
         (!onlyActive || info.activePredicate(collective, furnitureType)))
-      append(ret, collective->getConstructions().getBuiltPositions(furnitureType));
-  if (c) {
-    ret = ret.filter([c](Position pos) { return c->canNavigateTo(pos); });
+      append(ret, c
+          ? collective->getConstructions().getReachablePositions(furnitureType, c->getPosition(),
+              c->getMovementType())
+          : collective->getConstructions().getBuiltPositions(furnitureType).getElems());
+  if (c)
     ret = tryInQuarters(ret, collective, c);
-  }
   return ret;
 }
 
@@ -164,9 +165,9 @@ PTask MinionTasks::generate(WCollective collective, WCreature c, MinionTask task
       break;
     }
     case MinionTaskInfo::ARCHERY: {
-      auto pos = collective->getConstructions().getBuiltPositions(FurnitureType::ARCHERY_RANGE);
+      auto& pos = collective->getConstructions().getBuiltPositions(FurnitureType::ARCHERY_RANGE);
       if (!pos.empty())
-        return Task::archeryRange(collective, tryInQuarters(vector<Position>(pos.begin(), pos.end()), collective, c));
+        return Task::archeryRange(collective, tryInQuarters(pos.getElems(), collective, c));
       else
         return nullptr;
     }
@@ -179,9 +180,9 @@ PTask MinionTasks::generate(WCollective collective, WCreature c, MinionTask task
         return Task::copulate(collective, target, 20);
       break;
     case MinionTaskInfo::EAT: {
-      const set<Position>& hatchery = collective->getConstructions().getBuiltPositions(FurnitureType::PIGSTY);
+      const PositionSet& hatchery = collective->getConstructions().getBuiltPositions(FurnitureType::PIGSTY);
       if (!hatchery.empty())
-        return Task::eat(tryInQuarters(vector<Position>(hatchery.begin(), hatchery.end()), collective, c));
+        return Task::eat(tryInQuarters(hatchery.getElems(), collective, c));
       break;
       }
     case MinionTaskInfo::SPIDER: {
@@ -52,13 +52,17 @@
 #include "player_control.h"
 #include "tutorial.h"
 #include "message_buffer.h"
+#include "field_of_view.h"
+#include "construction_map.h"
+#include "furniture_type.h"
+#include "task_map.h"
 
 template <class Archive> 
 void Model::serialize(Archive& ar, const unsigned int version) {
   CHECK(!serializationLocked);
   ar & SUBCLASS(OwnedObject<Model>);
   ar(portals, levels, collectives, timeQueue, deadCreatures, currentTime, woodCount, game, lastTick);
-  ar(stairNavigation, cemetery, topLevel, eventGenerator, externalEnemies);
+  ar(stairNavigation, cemetery, topLevel, eventGenerator, externalEnemies, lastCreatureTick, effectChanges);
 }
 
 SERIALIZATION_CONSTRUCTOR_IMPL(Model)
@@ -89,11 +93,6 @@ vector<WCollective> Model::getCollectives() const {
   return getWeakPointers(collectives);
 }
 
-void Model::updateSunlightMovement() {
-  for (PLevel& l : levels)
-    l->updateSunlightMovement();
-}
-
 void Model::checkCreatureConsistency() {
   EntitySet<Creature> tmp;
   for (WCreature c : timeQueue->getAllCreatures()) {
@@ -132,9 +131,67 @@ bool Model::update(double totalTime) {
   return false;
 }
 
+static const int observedCellSize = FieldOfView::sightRange;
+
+optional<unordered_map<LevelId, Table<bool>>> Model::getObservedCells() const {
+  if (!game)
+    return none;
+  vector<Position> observers;
+  for (WCreature c : game->getPlayerCreatures())
+    observers.push_back(c->getPosition());
+  if (WCollective col = game->getPlayerCollective()) {
+    for (WCreature c : col->getCreatures())
+      observers.push_back(c->getPosition());
+    for (auto& pos : col->getConstructions().getBuiltPositions(FurnitureType::EYEBALL))
+      observers.push_back(pos);
+    for (auto& pos : col->getTaskMap().getActiveTaskPositions())
+      observers.push_back(pos);
+  }
+  if (observers.empty())
+    return none;
+  unordered_map<LevelId, Table<bool>> ret;
+  for (auto& level : levels)
+    ret.emplace(level->getUniqueId(), Table<bool>(Rectangle(
+        level->getBounds().getSize() / observedCellSize + Vec2(1, 1)), false));
+  for (auto& pos : observers)
+    if (WLevel level = pos.getLevel()) {
+      auto cells = ret.find(level->getUniqueId());
+      if (cells != ret.end())
+        for (Vec2 v : Rectangle::centered(pos.getCoord() / observedCellSize, 1))
+          if (v.inRectangle(cells->second.getBounds()))
+            cells->second[v] = true;
+    }
+  return ret;
+}
+
 void Model::tick(LocalTime time) {
-  for (WCreature c : timeQueue->getAllCreatures()) {
-    c->tick();
+  // Creatures far from anything the player observes are ticked every few turns and catch up on the missed turns
+  // in a single call. Creatures with a timed lasting effect are ticked every turn, and so is a creature whose
+  // effects were changed since its last tick. Such a creature catches up on the turns before the change with the
+  // effects as they were (see onEffectsChanged).
+  static const auto remoteTickInterval = 5_visible;
+  auto observedCells = getObservedCells();
+  auto isObserved = [&](WConstCreature c) {
+    if (!observedCells || c->isPlayer())
+      return true;
+    WLevel level = c->getPosition().getLevel();
+    if (!level || !observedCells->count(level->getUniqueId()))
+      return true;
+    return observedCells->at(level->getUniqueId())[c->getPosition().getCoord() / observedCellSize];
+  };
+  // Creatures can die during their tick, so iterate over a copy.
+  for (WCreature c : copyOf(timeQueue->getAllCreatures())) {
+    if (!lastCreatureTick.hasKey(c))
+      lastCreatureTick.set(c, time - 1_visible);
+    auto elapsed = time - lastCreatureTick.getOrFail(c);
+    if (elapsed <= 0_visible || (elapsed < remoteTickInterval && !isObserved(c) && !effectChanges.hasKey(c) &&
+        !c->getAttributes().hasTimedLastingEffect(*c->getGlobalTime())))
+      continue;
+    auto changedEffects = getChangedEffectTurns(lastCreatureTick.getOrFail(c), time,
+        effectChanges.getOrElse(c, {}));
+    lastCreatureTick.set(c, time);
+    effectChanges.erase(c);
+    c->tick(elapsed, changedEffects);
   }
   for (PLevel& l : levels)
     l->tick();
@@ -142,6 +199,47 @@ void Model::tick(LocalTime time) {
     col->tick();
   if (externalEnemies)
     externalEnemies->update(getTopLevel(), time);
+  precomputeFieldOfView(time);
+}
+
+void Model::onEffectsChanged(WCreature c, LastingEffect effect) {
+  if (lastCreatureTick.hasKey(c))
+    effectChanges.getOrInit(c).push_back(EffectChange{effect, lastTick, c->isAffected(effect)});
+}
+
+vector<pair<LastingEffect, LastingEffectTurns>> Model::getChangedEffectTurns(LocalTime lastTick, LocalTime time,
+    const vector<EffectChange>& changes) {
+  vector<pair<LastingEffect, LastingEffectTurns>> ret;
+  vector<LocalTime> lastChange;
+  for (auto& change : changes) {
+    optional<int> index;
+    for (int i : All(ret))
+      if (ret[i].first == change.effect)
+        index = i;
+    if (!index) {
+      index = ret.size();
+      ret.push_back({change.effect, LastingEffectTurns{0, 0}});
+      lastChange.push_back(lastTick);
+    }
+    if (change.wasAffected)
+      ret[*index].second.before += (change.time - lastChange[*index]).getVisibleInt();
+    lastChange[*index] = change.time;
+  }
+  for (int i : All(ret))
+    ret[i].second.since = (time - lastChange[i]).getVisibleInt();
+  return ret;
+}
+
+void Model::precomputeFieldOfView(LocalTime time) {
+  unordered_map<LevelId, vector<WCreature>> creatures;
+  for (WCreature c : timeQueue->getAllCreatures())
+    // Sleeping creatures don't look around during their move.
+    if (timeQueue->getTime(c) < time + 1_visible && !c->hasCondition(CreatureCondition::SLEEPING))
+      if (WLevel level = c->getLevel())
+        creatures[level->getUniqueId()].push_back(c);
+  for (PLevel& level : levels)
+    if (creatures.count(level->getUniqueId()))
+      level->precomputeFieldOfView(creatures.at(level->getUniqueId()));
 }
 
 void Model::addCreature(PCreature c) {
@@ -262,11 +360,15 @@ WLevel Model::getTopLevel() const {
 }
 
 void Model::killCreature(WCreature c) {
+  lastCreatureTick.erase(c);
+  effectChanges.erase(c);
   deadCreatures.push_back(timeQueue->removeCreature(c));
   cemetery->landCreature(cemetery->getAllPositions(), c);
 }
 
 PCreature Model::extractCreature(WCreature c) {
+  lastCreatureTick.erase(c);
+  effectChanges.erase(c);
   PCreature ret = timeQueue->removeCreature(c);
   c->getLevel()->removeCreature(c);
   return ret;
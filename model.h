@@ -23,6 +23,7 @@
 #include "enum_variant.h"
 #include "event_generator.h"
 #include "game_time.h"
+#include "entity_map.h"
 
 class Level;
 class ProgressMeter;
@@ -33,6 +34,7 @@ class StairKey;
 class Game;
 class ExternalEnemies;
 class Options;
+struct LastingEffectTurns;
 
 /**
   * Main class that holds all game logic.
@@ -69,6 +71,20 @@ class Model : public OwnedObject<Model> {
   void setGame(WGame);
   WGame getGame() const;
   void tick(LocalTime);
+  /** Called before one of the creature's lasting effects changes. Makes sure that the creature is ticked on the
+      next turn, even if it's far from the player's view, and that the turns before the change are caught up
+      with the effect as it was.*/
+  void onEffectsChanged(WCreature, LastingEffect);
+  struct EffectChange {
+    LastingEffect SERIAL(effect);
+    /** Model time of the last tick before the change.*/
+    LocalTime SERIAL(time);
+    bool SERIAL(wasAffected);
+    SERIALIZE_ALL(effect, time, wasAffected)
+  };
+  /** Splits a catch-up tick over (lastTick, time] into the turns each changed effect was active for.*/
+  static vector<pair<LastingEffect, LastingEffectTurns>> getChangedEffectTurns(LocalTime lastTick, LocalTime time,
+      const vector<EffectChange>&);
   vector<WCollective> getCollectives() const;
   vector<WCreature> getAllCreatures() const;
   vector<WLevel> getLevels() const;
@@ -81,7 +97,6 @@ class Model : public OwnedObject<Model> {
   int getSaveProgressCount() const;
 
   void killCreature(WCreature victim);
-  void updateSunlightMovement();
 
   optional<Position> getOtherPortal(Position) const;
   void registerPortal(Position);
@@ -129,6 +144,12 @@ class Model : public OwnedObject<Model> {
   friend class EventListener;
   OwnerPointer<EventGenerator> SERIAL(eventGenerator);
   void checkCreatureConsistency();
+  void precomputeFieldOfView(LocalTime);
+  /** Marks coarse cells of each level that are near the player's creatures or eyeballs. Returns none if there is
+      nothing to observe from, e.g. when spectating.*/
+  optional<unordered_map<LevelId, Table<bool>>> getObservedCells() const;
+  EntityMap<Creature, LocalTime> SERIAL(lastCreatureTick);
+  EntityMap<Creature, vector<EffectChange>> SERIAL(effectChanges);
   HeapAllocated<optional<ExternalEnemies>> SERIAL(externalEnemies);
   vector<Position> SERIAL(portals);
   int moveCounter = 0;
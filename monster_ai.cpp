@@ -17,6 +17,7 @@
 
 #include "monster_ai.h"
 #include "level.h"
+#include "field_of_view.h"
 #include "collective.h"
 #include "effect.h"
 #include "item.h"
@@ -68,29 +69,21 @@ Behaviour::Behaviour(WCreature c) : creature(c) {
 }
 
 WCreature Behaviour::getClosestEnemy() {
-  int dist = 1000000000;
-  WCreature result = nullptr;
-  for (WCreature other : creature->getVisibleEnemies()) {
-    int curDist = other->getPosition().dist8(creature->getPosition());
-    if (curDist < dist &&
-        ((!other->getAttributes().dontChase() && !other->getStatus().contains(CreatureStatus::CIVILIAN))
-            || curDist == 1)) {
-      result = other;
-      dist = creature->getPosition().dist8(other->getPosition());
-    }
-  }
-  return result;
+  return creature->getPosition().getLevel()->getClosestCreature(creature->getPosition().getCoord(),
+      FieldOfView::sightRange, [&](WCreature other) {
+        if (other == creature || !creature->isEnemy(other) ||
+            (!creature->canSee(other) && !creature->isUnknownAttacker(other)))
+          return false;
+        return (!other->getAttributes().dontChase() && !other->getStatus().contains(CreatureStatus::CIVILIAN)) ||
+            other->getPosition().dist8(creature->getPosition()) == 1;
+      });
 }
 
 WCreature Behaviour::getClosestCreature() {
-  int dist = 1000000000;
-  WCreature result = nullptr;
-  for (WCreature other : creature->getVisibleCreatures())
-    if (other != creature && other->getPosition().dist8(creature->getPosition()) < dist) {
-      result = other;
-      dist = creature->getPosition().dist8(other->getPosition());
-    }
-  return result;
+  return creature->getPosition().getLevel()->getClosestCreature(creature->getPosition().getCoord(),
+      FieldOfView::sightRange, [&](WCreature other) {
+        return other != creature && (creature->canSee(other) || creature->isUnknownAttacker(other));
+      });
 }
 
 WItem Behaviour::getBestWeapon() {
@@ -984,7 +977,9 @@ class SplashItems {
       return nullptr;
     Vec2 target = Random.choose(targets);
     targets.removeElement(target);
-    return Task::bringItem(callbackDummy.get(), Position(pos, level), it, {Position(target, level)}, 100);
+    PositionSet destination;
+    destination.insert(Position(target, level));
+    return Task::bringItem(callbackDummy.get(), Position(pos, level), it, destination, 100);
   }
 
   void setInitialized(const FilePath& splashPath) {
@@ -1118,17 +1113,32 @@ MonsterAI::MonsterAI(WCreature c, const vector<Behaviour*>& beh, const vector<in
 
 void MonsterAI::makeMove() {
   vector<pair<MoveInfo, int>> moves;
+  // The items on the ground are grouped into stacks only once per move, and only if some behaviour needs them.
+  optional<vector<pair<WItem, CreatureAction>>> pickUpOptions;
+  auto getPickUpOptions = [&] {
+    vector<pair<WItem, CreatureAction>> ret;
+    for (auto& stack : Item::stackItems(creature->getPickUpOptions())) {
+      WItem item = stack[0];
+      if (!item->isOrWasForSale())
+        if (auto action = creature->pickUp(stack))
+          ret.push_back({item, action});
+    }
+    return ret;
+  };
+  double bestValue = 0;
   for (int i : All(behaviours)) {
     MoveInfo move = behaviours[i]->getMove();
     move.setValue(move.getValue() * weights[i]);
     moves.emplace_back(move, weights[i]);
-    if (pickItems) {
-      for (auto& stack : Item::stackItems(creature->getPickUpOptions())) {
-        WItem item = stack[0];
-        if (!item->isOrWasForSale() && creature->pickUp(stack))
-          moves.emplace_back(
-              MoveInfo({ behaviours[i]->itemValue(item) * weights[i], creature->pickUp(stack)}),
-              weights[i]);
+    bestValue = max(bestValue, move.getValue());
+    // Item values are at most 1, so picking up can't beat a move that's already worth more than the weight.
+    if (pickItems && bestValue <= weights[i]) {
+      if (!pickUpOptions)
+        pickUpOptions = getPickUpOptions();
+      for (auto& option : *pickUpOptions) {
+        double value = behaviours[i]->itemValue(option.first) * weights[i];
+        moves.emplace_back(MoveInfo(value, option.second), weights[i]);
+        bestValue = max(bestValue, value);
       }
     }
   }
@@ -41,6 +41,18 @@ bool MovementSet::hasTrait(MovementTrait trait) const {
   return traits.contains(trait);
 }
 
+const EnumSet<MovementTrait>& MovementSet::getTraits() const {
+  return traits;
+}
+
+const EnumSet<MovementTrait>& MovementSet::getForcibleTraits() const {
+  return forcibleTraits;
+}
+
+bool MovementSet::isBlockingEnemies() const {
+  return blockingEnemies;
+}
+
 MovementSet& MovementSet::addTrait(MovementTrait trait) {
   traits.insert(trait);
   return *this;
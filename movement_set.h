@@ -13,6 +13,9 @@ class MovementSet {
   bool canEnter(const MovementType&) const;
 
   bool hasTrait(MovementTrait) const;
+  const EnumSet<MovementTrait>& getTraits() const;
+  const EnumSet<MovementTrait>& getForcibleTraits() const;
+  bool isBlockingEnemies() const;
 
   MovementSet& addTrait(MovementTrait);
   MovementSet& removeTrait(MovementTrait);
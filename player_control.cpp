@@ -178,7 +178,7 @@ void PlayerControl::onControlledKilled(WConstCreature victim) {
 
 void PlayerControl::onSunlightVisibilityChanged() {
   for (auto pos : getCollective()->getConstructions().getBuiltPositions(FurnitureType::EYEBALL))
-    visibilityMap->updateEyeball(pos);
+    updateEyeball(pos);
 }
 
 void PlayerControl::setTutorial(STutorial t) {
@@ -681,7 +681,7 @@ VillageInfo::Village PlayerControl::getVillageInfo(WConstCollective col) const {
 
 void PlayerControl::handleTrading(WCollective ally) {
   ScrollPosition scrollPos;
-  const set<Position>& storage = getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT);
+  const PositionSet& storage = getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT);
   if (storage.empty()) {
     getView()->presentText("Information", "You need a storage room for equipment in order to trade.");
     return;
@@ -701,7 +701,7 @@ void PlayerControl::handleTrading(WCollective ally) {
     for (WItem it : available)
       if (it->getUniqueId() == *index && it->getPrice() <= budget) {
         getCollective()->takeResource({ResourceId::GOLD, it->getPrice()});
-        Random.choose(storage).dropItem(ally->buyItem(it));
+        Random.choose(storage.getElems()).dropItem(ally->buyItem(it));
       }
     getView()->updateView(this, true);
   }
@@ -727,7 +727,7 @@ static vector<PItem> retrieveItems(WCollective col, vector<WItem> items) {
   for (auto pos : col->getTerritory().getAll()) {
     for (auto item : copyOf(pos.getInventory().getItems()))
       if (index.contains(item))
-        ret.push_back(pos.modInventory().removeItem(item));
+        ret.push_back(pos.removeItem(item));
   }
   return ret;
 }
@@ -737,7 +737,7 @@ void PlayerControl::handlePillage(WCollective col) {
   while (1) {
     struct PillageOption {
       vector<WItem> items;
-      set<Position> storage;
+      PositionSet storage;
     };
     vector<PillageOption> options;
     for (auto& elem : Item::stackItems(col->getAllItems(false)))
@@ -753,7 +753,7 @@ void PlayerControl::handlePillage(WCollective col) {
     if (!index)
       break;
     CHECK(!options[*index].storage.empty());
-    Random.choose(options[*index].storage).dropItems(retrieveItems(col, options[*index].items));
+    Random.choose(options[*index].storage.getElems()).dropItems(retrieveItems(col, options[*index].items));
     getView()->updateView(this, true);
   }
 }
@@ -913,7 +913,7 @@ void PlayerControl::fillLibraryInfo(CollectiveInfo& collectiveInfo) const {
     auto& info = *collectiveInfo.libraryInfo;
     int libraryCount = 0;
     for (auto f : CollectiveConfig::getTrainingFurniture(ExperienceType::SPELL))
-      libraryCount += getCollective()->getConstructions().getBuiltPositions(f).size();
+      libraryCount += getCollective()->getConstructions().getBuiltPositions(f).getSize();
     if (libraryCount == 0)
       info.warning = "You need to build a library to start research."_s;
     else if (libraryCount <= getMinLibrarySize())
@@ -1255,9 +1255,58 @@ void PlayerControl::updateMinionVisibility(WConstCreature c) {
     if (getCollective()->addKnownTile(pos))
       updateKnownLocations(pos);
     addToMemory(pos);
+    if (WCreature other = pos.getCreature())
+      addRecruitCandidate(other);
   }
 }
 
+void PlayerControl::updateEyeball(Position pos) {
+  for (Position v : visibilityMap->updateEyeball(pos))
+    if (WCreature c = v.getCreature())
+      addRecruitCandidate(c);
+}
+
+void PlayerControl::addRecruitCandidate(WCreature c) {
+  if (c->getTribeId() == getTribeId() && !getCreatures().contains(c) && !recruitCandidateIds.contains(c)) {
+    recruitCandidates.push_back(c);
+    recruitCandidateIds.insert(c);
+  }
+}
+
+void PlayerControl::removeRecruitCandidate(WCreature c) {
+  recruitCandidates.removeElement(c);
+  recruitCandidateIds.erase(c);
+}
+
+vector<WCreature> PlayerControl::getRecruitCandidates(const vector<WLevel>& levels) {
+  // Creatures don't generate events while they stand still, so look at every creature on a level once when it
+  // becomes current, including after loading the game, and again when SHOW_MAP changes what we can see.
+  bool showMap = getGame()->getOptions()->getBoolValue(OptionId::SHOW_MAP);
+  if (showMap != recruitScannedShowMap) {
+    recruitScannedShowMap = showMap;
+    recruitScannedLevels.clear();
+  }
+  for (WLevel l : levels)
+    if (!recruitScannedLevels.contains(l)) {
+      recruitScannedLevels.push_back(l);
+      for (WCreature c : l->getAllCreatures())
+        addRecruitCandidate(c);
+    }
+  vector<WCreature> ret;
+  vector<WCreature> remaining;
+  for (WCreature c : recruitCandidates)
+    if (c && !c->isDead() && c->getTribeId() == getTribeId() && !getCreatures().contains(c)) {
+      remaining.push_back(c);
+      if (levels.contains(c->getLevel()))
+        ret.push_back(c);
+    }
+  if (remaining.size() < recruitCandidates.size()) {
+    recruitCandidates = remaining;
+    recruitCandidateIds = EntitySet<Creature>(remaining);
+  }
+  return ret;
+}
+
 void PlayerControl::onEvent(const GameEvent& event) {
   using namespace EventInfo;
   event.visit(
@@ -1270,11 +1319,16 @@ void PlayerControl::onEvent(const GameEvent& event) {
           addMessage(PlayerMessage(info.message).setCreature(info.creature->getUniqueId()));
       },
       [&](const VisibilityChanged& info) {
-        visibilityMap->onVisibilityChanged(info.pos);
+        visibilityMap->onVisibilityChanged(info.positions);
+        for (auto& pos : info.positions)
+          if (WCreature c = pos.getCreature())
+            addRecruitCandidate(c);
       },
       [&](const CreatureMoved& info) {
         if (getCreatures().contains(info.creature))
           updateMinionVisibility(info.creature);
+        else
+          addRecruitCandidate(info.creature);
       },
       [&](const ItemsEquipped& info) {
         if (info.creature->isPlayer() &&
@@ -2278,28 +2332,28 @@ void PlayerControl::update(bool currentlyActive) {
   for (auto c : getControlled())
     if (!currentLevels.contains(c->getLevel()))
       currentLevels.push_back(c->getLevel());
-  for (WLevel l : currentLevels)
-    for (WCreature c : l->getAllCreatures())
-      if (!getCreatures().contains(c) && c->getTribeId() == getTribeId() && canSee(c) && !isEnemy(c)) {
-        if (!getCollective()->wasBanished(c) && !c->getBody().isMinionFood()) {
-          addedCreatures.push_back(c);
-          getCollective()->addCreature(c, {MinionTrait::FIGHTER});
-          for (auto controlled : getControlled())
-            if ((getCollective()->hasTrait(controlled, MinionTrait::FIGHTER)
-                  || controlled == getCollective()->getLeader())
-                && c->getPosition().isSameLevel(controlled->getPosition())) {
-              for (auto team : getTeams().getActive(controlled)) {
-                getTeams().add(team, c);
-                controlled->privateMessage(PlayerMessage(c->getName().a() + " joins your team.",
-                      MessagePriority::HIGH));
-                break;
-              }
+  for (WCreature c : getRecruitCandidates(currentLevels))
+    if (canSee(c) && !isEnemy(c)) {
+      removeRecruitCandidate(c);
+      if (!getCollective()->wasBanished(c) && !c->getBody().isMinionFood()) {
+        addedCreatures.push_back(c);
+        getCollective()->addCreature(c, {MinionTrait::FIGHTER});
+        for (auto controlled : getControlled())
+          if ((getCollective()->hasTrait(controlled, MinionTrait::FIGHTER)
+                || controlled == getCollective()->getLeader())
+              && c->getPosition().isSameLevel(controlled->getPosition())) {
+            for (auto team : getTeams().getActive(controlled)) {
+              getTeams().add(team, c);
+              controlled->privateMessage(PlayerMessage(c->getName().a() + " joins your team.",
+                    MessagePriority::HIGH));
               break;
             }
-        } else
-          if (c->getBody().isMinionFood())
-            getCollective()->addCreature(c, {MinionTrait::FARM_ANIMAL, MinionTrait::NO_LIMIT});
-      }
+            break;
+          }
+      } else
+        if (c->getBody().isMinionFood())
+          getCollective()->addCreature(c, {MinionTrait::FARM_ANIMAL, MinionTrait::NO_LIMIT});
+    }
   if (!addedCreatures.empty()) {
     getCollective()->addNewCreatureMessage(addedCreatures);
   }
@@ -2307,7 +2361,7 @@ void PlayerControl::update(bool currentlyActive) {
 
 bool PlayerControl::isConsideredAttacking(WConstCreature c, WConstCollective enemy) {
   if (enemy && enemy->getModel() == getModel())
-    return canSee(c) && getCollective()->getTerritory().getStandardExtended().contains(c->getPosition());
+    return canSee(c) && getCollective()->getTerritory().isInStandardExtended(c->getPosition());
   else
     return canSee(c) && c->getLevel() == getLevel();
 }
@@ -2410,7 +2464,7 @@ void PlayerControl::updateSquareMemory(Position pos) {
 
 void PlayerControl::onConstructed(Position pos, FurnitureType type) {
   if (type == FurnitureType::EYEBALL)
-    visibilityMap->updateEyeball(pos);
+    updateEyeball(pos);
 }
 
 PController PlayerControl::createMinionController(WCreature c) {
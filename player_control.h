@@ -220,6 +220,17 @@ class PlayerControl : public CreatureView, public CollectiveControl, public Even
   bool isNight = true;
   optional<UniqueEntity<Creature>::Id> draggedCreature;
   void updateMinionVisibility(WConstCreature);
+  /** Creatures of our tribe that came into view and may join the collective. They stay until they join or can't
+      join anymore.*/
+  vector<WCreature> recruitCandidates;
+  EntitySet<Creature> recruitCandidateIds;
+  /** Levels whose creatures were all added to the candidates, with the SHOW_MAP setting at the time.*/
+  vector<WLevel> recruitScannedLevels;
+  bool recruitScannedShowMap = false;
+  void addRecruitCandidate(WCreature);
+  void removeRecruitCandidate(WCreature);
+  void updateEyeball(Position);
+  vector<WCreature> getRecruitCandidates(const vector<WLevel>&);
   STutorial SERIAL(tutorial);
   void setChosenLibrary(bool);
   void acquireTech(int index);
@@ -28,6 +28,25 @@ int Position::getHash() const {
   return combineHash(coord, level->getUniqueId());
 }
 
+static const int packedCoordBits = 9;
+static_assert(Level::maxCacheIndex <= (1 << (32 - 2 * packedCoordBits)), "Cache index doesn't fit in PackedPosition");
+
+PackedPosition::PackedPosition(Position pos) {
+  Vec2 coord = pos.getCoord();
+  CHECK(pos.getLevel() && coord.inRectangle(Rectangle(1 << packedCoordBits, 1 << packedCoordBits))) <<
+      "Can't pack position " << coord;
+  value = (uint64_t(pos.getLevel()->getCacheGeneration()) << 32) |
+      (uint64_t(pos.getLevel()->getCacheIndex()) << (2 * packedCoordBits)) |
+      (uint64_t(coord.x) << packedCoordBits) | uint64_t(coord.y);
+}
+
+PackedPosition::operator Position() const {
+  const uint32_t mask = (1 << packedCoordBits) - 1;
+  uint32_t low = uint32_t(value);
+  return Position(Vec2((low >> packedCoordBits) & mask, low & mask),
+      Level::getByCacheIndex(low >> (2 * packedCoordBits), uint32_t(value >> 32)));
+}
+
 Vec2 Position::getCoord() const {
   return coord;
 }
@@ -366,6 +385,9 @@ bool Position::canEnterEmpty(WConstCreature c) const {
 bool Position::canEnterEmpty(const MovementType& t, optional<FurnitureLayer> ignore) const {
   if (isUnavailable())
     return false;
+  if (!ignore || ignore == FurnitureLayer::MIDDLE)
+    if (auto ret = level->tileFlags.canEnterEmpty(coord, t, !!ignore))
+      return *ret;
   auto square = getSquare();
   bool result = true;
   for (auto furniture : getFurniture()) {
@@ -608,6 +630,7 @@ void Position::throwItem(vector<PItem> item, const Attack& attack, int maxDist,
 
 void Position::updateConnectivity() const {
   if (isValid()) {
+    level->updateTileFlags(coord);
     for (auto& elem : level->sectors)
       if (canNavigate(elem.first))
         elem.second.add(coord);
@@ -670,17 +693,11 @@ optional<double> Position::getNavigationCost(const MovementType& movement) const
 }
 
 bool Position::canSeeThru(VisionId id) const {
-  if (auto furniture = getFurniture(FurnitureLayer::MIDDLE))
-    return furniture->canSeeThru(id);
-  else
-    return isValid();
+  return isValid() && level->tileFlags.canSeeThru(coord, id);
 }
 
 bool Position::stopsProjectiles(VisionId id) const {
-  if (auto furniture = getFurniture(FurnitureLayer::MIDDLE))
-    return furniture->stopsProjectiles(id);
-  else
-    return !isValid();
+  return !isValid() || level->tileFlags.stopsProjectiles(coord, id);
 }
 
 bool Position::isVisibleBy(WConstCreature c) const {
@@ -688,8 +705,10 @@ bool Position::isVisibleBy(WConstCreature c) const {
 }
 
 void Position::clearItemIndex(ItemIndex index) const {
-  if (isValid())
+  if (isValid()) {
     modSquare()->clearItemIndex(index);
+    level->onItemsChanged(coord);
+  }
 }
 
 bool Position::isChokePoint(const MovementType& movement) const {
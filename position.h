@@ -139,6 +139,27 @@ class Position {
   void updateSupport() const;
 };
 
+/** A Position packed into 64 bits: the level's cache generation, its cache index and 9 bits per coordinate.
+    It's meant for bulk storage and hashing of positions within Level::getMaxBounds(). It's not serializable.
+    If its level is destroyed it unpacks to a position without a level, even if the cache index was reused.*/
+class PackedPosition {
+  public:
+  PackedPosition(Position);
+  operator Position() const;
+  bool operator == (PackedPosition o) const {
+    return value == o.value;
+  }
+  bool operator != (PackedPosition o) const {
+    return value != o.value;
+  }
+  int getHash() const {
+    return int(value ^ (value >> 32));
+  }
+
+  private:
+  uint64_t value;
+};
+
 template <>
 inline string toString(const Position& t) {
 	stringstream ss;
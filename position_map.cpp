@@ -9,72 +9,112 @@
 #include "furniture_layer.h"
 #include "construction_map.h"
 
+static const int chunkSize = 16;
+
 template <class T>
-PositionMap<T>::PositionMap(const T& def) : defaultVal(def) {
+PositionMap<T>::LevelTable::LevelTable(Rectangle b) : bounds(b),
+    chunks((b.width() + chunkSize - 1) / chunkSize, (b.height() + chunkSize - 1) / chunkSize) {
 }
 
 template <class T>
-const T& PositionMap<T>::get(Position pos) const {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  try {
-    const Table<T>& table = tables.at(levelId);
-    if (pos.getCoord().inRectangle(table.getBounds()))
-      return table[pos.getCoord()];
-    else
-      return outliers.at(levelId).at(pos.getCoord());
-  } catch (std::out_of_range) {
-    return defaultVal;
+const T* PositionMap<T>::LevelTable::get(Vec2 v) const {
+  if (auto& chunk = chunks[(v - bounds.topLeft()) / chunkSize])
+    return &(*chunk)[v];
+  else
+    return nullptr;
+}
+
+template <class T>
+T& PositionMap<T>::LevelTable::getOrInit(Vec2 v, const T& defaultVal) {
+  Vec2 chunkPos = (v - bounds.topLeft()) / chunkSize;
+  auto& chunk = chunks[chunkPos];
+  if (!chunk) {
+    Vec2 corner = bounds.topLeft() + chunkPos * chunkSize;
+    chunk = Table<T>(Rectangle(corner, corner + Vec2(chunkSize, chunkSize)), defaultVal);
   }
+  return (*chunk)[v];
 }
 
 template <class T>
-Table<T>& PositionMap<T>::getTable(Position pos) {
+typename PositionMap<T>::TableCache& PositionMap<T>::TableCache::operator = (const TableCache&) {
+  tables.clear();
+  return *this;
+}
+
+template <class T>
+PositionMap<T>::PositionMap(const T& def) : defaultVal(def) {
+}
+
+template <class T>
+const typename PositionMap<T>::LevelTable* PositionMap<T>::getTable(Position pos) const {
+  int index = pos.getLevel()->getCacheIndex();
   LevelId levelId = pos.getLevel()->getUniqueId();
-  try {
-    return tables.at(levelId);
-  } catch (std::out_of_range) {
-    auto it = tables.insert(make_pair(levelId, Table<T>(pos.getLevel()->getBounds().minusMargin(-20), defaultVal)));
-    return it.first->second;
+  auto& cached = tableCache.tables;
+  if (index < cached.size() && cached[index].second && cached[index].first == levelId)
+    return cached[index].second;
+  auto it = tables.find(levelId);
+  if (it == tables.end())
+    return nullptr;
+  while (cached.size() <= index)
+    cached.push_back({0, nullptr});
+  // Map nodes are never moved, so the pointer stays valid until the entry is erased in limitToModel.
+  cached[index] = {levelId, const_cast<LevelTable*>(&it->second)};
+  return cached[index].second;
+}
+
+template <class T>
+typename PositionMap<T>::LevelTable& PositionMap<T>::getOrInitTable(Position pos) {
+  if (auto table = getTable(pos))
+    return const_cast<LevelTable&>(*table);
+  tables.insert(make_pair(pos.getLevel()->getUniqueId(), LevelTable(pos.getLevel()->getBounds().minusMargin(-20))));
+  return const_cast<LevelTable&>(*getTable(pos));
+}
+
+template <class T>
+const T* PositionMap<T>::find(Position pos) const {
+  if (auto table = getTable(pos)) {
+    if (pos.getCoord().inRectangle(table->bounds))
+      return table->get(pos.getCoord());
+    auto levelOutliers = outliers.find(pos.getLevel()->getUniqueId());
+    if (levelOutliers != outliers.end()) {
+      auto it = levelOutliers->second.find(pos.getCoord());
+      if (it != levelOutliers->second.end())
+        return &it->second;
+    }
   }
+  return nullptr;
+}
+
+template <class T>
+const T& PositionMap<T>::get(Position pos) const {
+  if (auto elem = find(pos))
+    return *elem;
+  else
+    return defaultVal;
 }
 
 template <class T>
 T& PositionMap<T>::getOrInit(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  Table<T>& table = getTable(pos);
-  if (pos.getCoord().inRectangle(table.getBounds())) {
-    return table[pos.getCoord()];
-  }
-  else try {
-    return outliers.at(levelId).at(pos.getCoord());
-  } catch (std::out_of_range) {
-    return outliers[levelId][pos.getCoord()]  = defaultVal;
-  }
+  LevelTable& table = getOrInitTable(pos);
+  if (pos.getCoord().inRectangle(table.bounds))
+    return table.getOrInit(pos.getCoord(), defaultVal);
+  auto& levelOutliers = outliers[pos.getLevel()->getUniqueId()];
+  auto it = levelOutliers.find(pos.getCoord());
+  if (it == levelOutliers.end())
+    it = levelOutliers.insert(make_pair(pos.getCoord(), defaultVal)).first;
+  return it->second;
 }
 
 template <class T>
 T& PositionMap<T>::getOrFail(Position pos) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  try {
-    Table<T>& table = tables.at(levelId);
-    if (pos.getCoord().inRectangle(table.getBounds()))
-      return table[pos.getCoord()];
-    else
-      return outliers.at(levelId).at(pos.getCoord());
-  } catch (std::out_of_range) {
-    FATAL << "getOrFail failed " << pos.getCoord();
-    return defaultVal;
-  }
+  auto table = getTable(pos);
+  CHECK(table && (pos.getCoord().inRectangle(table->bounds) || find(pos))) << "getOrFail failed " << pos.getCoord();
+  return getOrInit(pos);
 }
 
 template <class T>
 void PositionMap<T>::set(Position pos, const T& elem) {
-  LevelId levelId = pos.getLevel()->getUniqueId();
-  Table<T>& table = getTable(pos);
-  if (pos.getCoord().inRectangle(table.getBounds()))
-    table[pos.getCoord()] = elem;
-  else
-    outliers[levelId][pos.getCoord()] = elem;
+  getOrInit(pos) = elem;
 }
 
 template <class T>
@@ -88,6 +128,7 @@ void PositionMap<T>::limitToModel(const WModel m) {
   for (auto& elem : copyOf(outliers))
     if (!goodIds.count(elem.first))
       outliers.erase(elem.first);
+  tableCache.tables.clear();
 }
 
 template <class T>
@@ -20,9 +20,30 @@ class PositionMap {
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  Table<T>& getTable(Position);
-  map<LevelId, Table<T>> SERIAL(tables);
+  /** Values of a single level, kept in square chunks that are allocated on first write.*/
+  struct LevelTable {
+    LevelTable(Rectangle bounds);
+    const T* get(Vec2) const;
+    T& getOrInit(Vec2, const T& defaultVal);
+    Rectangle SERIAL(bounds);
+    Table<optional<Table<T>>> SERIAL(chunks);
+    SERIALIZATION_CONSTRUCTOR(LevelTable)
+    SERIALIZE_ALL(bounds, chunks)
+  };
+  /** Maps Level::getCacheIndex() to tables, so lookups don't search the map. Cache indexes are reused by
+      new levels, so the level id is stored too. Copies start out empty.*/
+  struct TableCache {
+    TableCache() {}
+    TableCache(const TableCache&) {}
+    TableCache& operator = (const TableCache&);
+    vector<pair<LevelId, LevelTable*>> tables;
+  };
+  const LevelTable* getTable(Position) const;
+  LevelTable& getOrInitTable(Position);
+  const T* find(Position) const;
+  map<LevelId, LevelTable> SERIAL(tables);
   map<LevelId, map<Vec2, T>> SERIAL(outliers);
   T SERIAL(defaultVal);
+  mutable TableCache tableCache;
 };
 
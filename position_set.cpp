@@ -0,0 +1,55 @@
+#include "stdafx.h"
+#include "position_set.h"
+
+SERIALIZE_DEF(PositionSet, elems)
+
+PositionMap<int>& PositionSet::getIndex() const {
+  if (!index) {
+    index = PositionMap<int>();
+    for (int i : All(elems))
+      index->set(elems[i], i + 1);
+  }
+  return *index;
+}
+
+void PositionSet::insert(Position pos) {
+  int& elemIndex = getIndex().getOrInit(pos);
+  if (elemIndex == 0) {
+    elems.push_back(pos);
+    elemIndex = elems.size();
+  }
+}
+
+void PositionSet::erase(Position pos) {
+  auto& index = getIndex();
+  if (int elemIndex = index.get(pos)) {
+    elems[elemIndex - 1] = elems.back();
+    index.set(elems.back(), elemIndex);
+    elems.pop_back();
+    index.set(pos, 0);
+  }
+}
+
+bool PositionSet::contains(Position pos) const {
+  return getIndex().get(pos) > 0;
+}
+
+bool PositionSet::empty() const {
+  return elems.empty();
+}
+
+int PositionSet::getSize() const {
+  return elems.size();
+}
+
+const vector<Position>& PositionSet::getElems() const {
+  return elems;
+}
+
+PositionSet::Iter PositionSet::begin() const {
+  return elems.begin();
+}
+
+PositionSet::Iter PositionSet::end() const {
+  return elems.end();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "util.h"
+#include "position.h"
+#include "position_map.h"
+
+/** A set of positions with constant time insertion, removal and lookup, which iterates over a contiguous vector.*/
+class PositionSet {
+  public:
+  void insert(Position);
+  void erase(Position);
+  bool contains(Position) const;
+  bool empty() const;
+  int getSize() const;
+  const vector<Position>& getElems() const;
+
+  typedef vector<Position>::const_iterator Iter;
+
+  Iter begin() const;
+  Iter end() const;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+  private:
+  PositionMap<int>& getIndex() const;
+  vector<Position> SERIAL(elems);
+  /** Maps elements to their index in elems plus one. It's built lazily, because the levels might not be
+      fully loaded yet when the set is deserialized.*/
+  mutable optional<PositionMap<int>> index;
+};
@@ -36,9 +36,18 @@ bool Sectors::contains(Vec2 v) const {
   return sectors[v] > -1;
 }
 
+int Sectors::getSector(Vec2 v) const {
+  return sectors[v];
+}
+
+int Sectors::getVersion() const {
+  return version;
+}
+
 void Sectors::add(Vec2 pos) {
   if (contains(pos))
     return;
+  ++version;
   set<int> neighbors;
   for (Vec2 v : pos.neighbors8())
     if (v.inRectangle(bounds) && contains(v))
@@ -147,6 +156,7 @@ bool Sectors::isChokePoint(Vec2 pos) const {
 void Sectors::remove(Vec2 pos) {
   if (!contains(pos))
     return;
+  ++version;
   --sizes[sectors[pos]];
   sectors[pos] = -1;
   for (Vec2 v : getDisjoint(pos))
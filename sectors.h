@@ -28,6 +28,9 @@ class Sectors {
   bool contains(Vec2) const;
   int getNumSectors() const;
   bool isChokePoint(Vec2) const;
+  /** Returns the id of the sector containing the tile, or -1. Ids are valid until getVersion() changes.*/
+  int getSector(Vec2) const;
+  int getVersion() const;
 
   SERIALIZATION_DECL(Sectors);
 
@@ -39,5 +42,6 @@ class Sectors {
   Rectangle SERIAL(bounds);
   Table<int> SERIAL(sectors);
   vector<int> SERIAL(sizes);
+  int version = 0;
 };
 
@@ -87,6 +87,8 @@ void Square::tick(Position pos) {
     }
     for (auto item : discarded)
       inventory->removeItem(item);
+    if (!discarded.empty())
+      pos.getLevel()->onItemsChanged(pos.getCoord());
   }
   poisonGas->tick(pos);
   if (creature && poisonGas->getAmount() > 0.2) {
@@ -164,6 +166,7 @@ void Square::dropItems(Position pos, vector<PItem> items) {
   setDirty(pos);
   pos.getLevel()->addTickingSquare(pos.getCoord());
   dropItemsLevelGen(std::move(items));
+  pos.getLevel()->onItemsChanged(pos.getCoord());
 }
 
 WCreature Square::getCreature() const {
@@ -194,12 +197,16 @@ WItem Square::getTopItem() const {
 
 PItem Square::removeItem(Position pos, WItem it) {
   setDirty(pos);
-  return getInventory().removeItem(it);
+  PItem ret = getInventory().removeItem(it);
+  pos.getLevel()->onItemsChanged(pos.getCoord());
+  return ret;
 }
 
 vector<PItem> Square::removeItems(Position pos, vector<WItem> it) {
   setDirty(pos);
-  return getInventory().removeItems(it);
+  vector<PItem> ret = getInventory().removeItems(it);
+  pos.getLevel()->onItemsChanged(pos.getCoord());
+  return ret;
 }
 
 void Square::setDirty(Position pos) {
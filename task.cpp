@@ -457,8 +457,8 @@ class BringItem : public PickItem {
   vector<Position> SERIAL(allTargets);
 };
 
-PTask Task::bringItem(WTaskCallback c, Position pos, vector<WItem> items, const set<Position>& target, int numRetries) {
-  return makeOwner<BringItem>(c, pos, items, vector<Position>(target.begin(), target.end()), numRetries);
+PTask Task::bringItem(WTaskCallback c, Position pos, vector<WItem> items, const PositionSet& target, int numRetries) {
+  return makeOwner<BringItem>(c, pos, items, target.getElems(), numRetries);
 }
 
 class ApplyItem : public BringItem {
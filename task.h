@@ -24,6 +24,7 @@
 
 class TaskCallback;
 class CreatureFactory;
+class PositionSet;
 
 using WTaskCallback = WeakPointer<TaskCallback>;
 
@@ -47,7 +48,7 @@ class Task : public UniqueEntity<Task>, public OwnedObject<Task> {
 
   static PTask construction(WTaskCallback, Position, FurnitureType);
   static PTask destruction(WTaskCallback, Position, WConstFurniture, DestroyAction);
-  static PTask bringItem(WTaskCallback, Position position, vector<WItem>, const set<Position>& target,
+  static PTask bringItem(WTaskCallback, Position position, vector<WItem>, const PositionSet& target,
       int numRetries = 10);
   static PTask applyItem(WTaskCallback, Position, WItem, Position target);
   enum SearchType { LAZY, RANDOM_CLOSE };
@@ -13,6 +13,18 @@ WTask TaskMap::getClosestTask(WCreature c) {
     for (WTask t : getWeakPointers(tasks))
       if (t->isDone())
         removeTask(t);
+  if (auto assigned = assignedTasks.getMaybe(c)) {
+    if (!*assigned) {
+      // The last matching found nothing for this worker. It's trusted only in the same turn and while no task
+      // has changed, since moving, sectors and delays also affect which tasks are available.
+      if (assignedVersion == version && c->getLocalTime() == assignedTime)
+        return nullptr;
+    } else if (auto task = taskById.getMaybe(**assigned)) {
+      assignedTasks.erase(c);
+      if (isAvailable(*task, c))
+        return *task;
+    }
+  }
   WTask closest = nullptr;
   for (PTask& task : tasks)
     if (task->canPerform(c))
@@ -33,11 +45,130 @@ WTask TaskMap::getClosestTask(WCreature c) {
   return closest;
 }
 
+bool TaskMap::isAvailable(WTask task, WCreature c) const {
+  auto pos = getPosition(task);
+  if (!pos || task->isDone() || !task->canPerform(c))
+    return false;
+  if (WConstCreature owner = getOwner(task)) {
+    // Same rule as in getClosestTask: a transferable task can be taken over by a worker that is close to it
+    // and closer than the current owner.
+    int dist = pos->dist8(c->getPosition());
+    if (owner == c || !task->canTransfer() || pos->dist8(owner->getPosition()) <= dist || dist > 6)
+      return false;
+  }
+  auto delayed = delayedTasks.getMaybe(task);
+  return c->canNavigateTo(*pos) && !task->isBlocked(c) && (!delayed || *delayed < c->getLocalTime());
+}
+
+void TaskMap::assignTasks(const vector<WCreature>& workers) {
+  auto workerIds = workers.transform([](WCreature c) { return c->getUniqueId(); });
+  optional<LocalTime> time;
+  if (!workers.empty())
+    time = workers[0]->getLocalTime();
+  // The workers move and task delays expire between turns, so a matching is only reused within the same turn.
+  if (assignedVersion == version && workerIds == assignedWorkers && time == assignedTime)
+    return;
+  assignedVersion = version;
+  assignedWorkers = workerIds;
+  assignedTime = time;
+  assignedTasks.clear();
+  vector<WTask> open;
+  vector<int> priority;
+  for (PTask& task : tasks)
+    if (!task->isDone() && (!getOwner(task.get()) || task->canTransfer()) && getPosition(task.get())) {
+      if (isPriorityTask(task.get()))
+        priority.push_back(open.size());
+      open.push_back(task.get());
+    }
+  if (workers.empty() || open.empty())
+    return;
+  // Each worker bids for all priority tasks and a few of the closest other tasks that it can perform.
+  // Priority tasks are worth more than any distance, so they are handed out first, wherever they are.
+  const int maxCandidates = 10;
+  const int priorityBonus = 1000000;
+  struct Candidate {
+    int task;
+    double value;
+  };
+  vector<vector<Candidate>> candidates(workers.size());
+  for (int i : All(workers)) {
+    auto workerPos = workers[i]->getPosition();
+    for (int j : priority)
+      if (isAvailable(open[j], workers[i]))
+        candidates[i].push_back({j, double(priorityBonus - getPosition(open[j])->dist8(workerPos))});
+    vector<pair<int, int>> byDistance;
+    for (int j : All(open))
+      if (!isPriorityTask(open[j]))
+        byDistance.push_back({getPosition(open[j])->dist8(workerPos), j});
+    // Only the closest tasks are checked for availability, so sort them in small batches.
+    int sorted = 0;
+    int numFound = 0;
+    for (int k = 0; k < byDistance.size() && numFound < maxCandidates; ++k) {
+      if (k == sorted) {
+        sorted = min<int>(byDistance.size(), sorted + maxCandidates);
+        std::partial_sort(byDistance.begin() + k, byDistance.begin() + sorted, byDistance.end());
+      }
+      auto& elem = byDistance[k];
+      if (isAvailable(open[elem.second], workers[i])) {
+        candidates[i].push_back({elem.second, double(-elem.first)});
+        ++numFound;
+      }
+    }
+  }
+  // Auction algorithm: unassigned workers bid for their best task, raising its price by how much they prefer
+  // it over the second best option. Values are integers, so with this epsilon the matching is optimal.
+  // Staying without a task is worth a bit less than any task, which keeps the price wars short.
+  const double epsilon = 1.0 / (workers.size() + 1);
+  double noTaskValue = 0;
+  for (auto& elem : candidates)
+    for (auto& candidate : elem)
+      noTaskValue = min(noTaskValue, candidate.value);
+  noTaskValue -= 1;
+  vector<double> price(open.size(), 0);
+  vector<int> owner(open.size(), -1);
+  vector<int> unassigned;
+  for (int i : All(workers))
+    if (!candidates[i].empty())
+      unassigned.push_back(i);
+    else
+      assignedTasks.set(workers[i], none);
+  // Bound the running time on a bad tick. Workers left in the queue fall back to getClosestTask().
+  int bidBudget = 50 * unassigned.size();
+  while (!unassigned.empty() && bidBudget-- > 0) {
+    int worker = unassigned.back();
+    unassigned.pop_back();
+    optional<int> best;
+    double bestValue = noTaskValue;
+    double secondValue = noTaskValue;
+    for (auto& candidate : candidates[worker]) {
+      double value = candidate.value - price[candidate.task];
+      if (value > bestValue) {
+        secondValue = bestValue;
+        bestValue = value;
+        best = candidate.task;
+      } else
+        secondValue = max(secondValue, value);
+    }
+    if (!best) {
+      assignedTasks.set(workers[worker], none);
+      continue;
+    }
+    price[*best] += bestValue - secondValue + epsilon;
+    if (owner[*best] != -1)
+      unassigned.push_back(owner[*best]);
+    owner[*best] = worker;
+  }
+  for (int j : All(open))
+    if (owner[j] != -1)
+      assignedTasks.set(workers[owner[j]], open[j]->getUniqueId());
+}
+
 vector<WConstTask> TaskMap::getAllTasks() const {
   return tasks.transform([] (const PTask& t) -> WConstTask { return t.get(); });
 }
 
 void TaskMap::setPriorityTasks(Position pos) {
+  ++version;
   for (WTask t : getTasks(pos))
     priorityTasks.insert(t);
   pos.setNeedsRenderUpdate(true);
@@ -49,6 +180,7 @@ WTask TaskMap::addTaskCost(PTask task, Position position, CostInfo cost) {
 }
 
 CostInfo TaskMap::removeTask(WTask task) {
+  ++version;
   if (!task->isDone())
     task->cancel();
   CostInfo cost;
@@ -69,6 +201,7 @@ CostInfo TaskMap::removeTask(WTask task) {
   if (auto pos = positionMap.getMaybe(task)) {
     reversePositions.getOrFail(*pos).removeElement(task);
     positionMap.erase(task);
+    removedPositions.push_back(*pos);
   }
   for (int i : All(tasks))
     if (tasks[i].get() == task) {
@@ -79,6 +212,12 @@ CostInfo TaskMap::removeTask(WTask task) {
   return cost;
 }
 
+vector<Position> TaskMap::extractRemovedPositions() {
+  vector<Position> ret;
+  swap(ret, removedPositions);
+  return ret;
+}
+
 CostInfo TaskMap::removeTask(UniqueEntity<Task>::Id id) {
   for (PTask& task : tasks)
     if (task->getUniqueId() == id) {
@@ -136,6 +275,7 @@ const vector<WTask>& TaskMap::getTasks(Position pos) const {
 }
 
 WTask TaskMap::addTaskFor(PTask task, WCreature c) {
+  ++version;
   CHECK(!hasTask(c)) << c->getName().bare() << " already has a task";
   CHECK(!taskByCreature.getMaybe(c));
   CHECK(!creatureByTask.getMaybe(task.get()));
@@ -150,6 +290,7 @@ WTask TaskMap::addTaskFor(PTask task, WCreature c) {
 }
 
 WTask TaskMap::addTask(PTask task, Position position) {
+  ++version;
   setPosition(task.get(), position);
   taskById.set(task->getUniqueId(), task.get());
   tasks.push_back(std::move(task));
@@ -170,6 +311,15 @@ optional<Position> TaskMap::getPosition(WTask task) const {
   return positionMap.getMaybe(task);
 }
 
+vector<Position> TaskMap::getActiveTaskPositions() const {
+  vector<Position> ret;
+  for (auto& task : tasks)
+    if (creatureByTask.hasKey(task.get()))
+      if (auto pos = positionMap.getMaybe(task.get()))
+        ret.push_back(*pos);
+  return ret;
+}
+
 WCreature TaskMap::getOwner(WConstTask task) const {
   if (auto c = creatureByTask.getMaybe(task))
     return *c;
@@ -178,6 +328,7 @@ WCreature TaskMap::getOwner(WConstTask task) const {
 }
 
 void TaskMap::freeTask(WTask task) {
+  ++version;
   if (auto c = creatureByTask.getMaybe(task)) {
     CHECK(taskByCreature.getMaybe(*c));
     taskByCreature.erase(*c);
@@ -187,11 +338,13 @@ void TaskMap::freeTask(WTask task) {
 }
 
 void TaskMap::setPosition(WTask task, Position position) {
+  ++version;
   positionMap.set(task, position);
   reversePositions.getOrInit(position).push_back(task);
 }
 
 CostInfo TaskMap::freeFromTask(WConstCreature c) {
+  ++version;
   if (WTask task = getTask(c)) {
     if (!task->canTransfer())
       return removeTask(task);
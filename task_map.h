@@ -21,6 +21,8 @@ class TaskMap {
   vector<WConstTask> getAllTasks() const;
   WCreature getOwner(WConstTask) const;
   optional<Position> getPosition(WTask) const;
+  /** Positions of the tasks that are taken by a creature.*/
+  vector<Position> getActiveTaskPositions() const;
   void takeTask(WCreature, WTask);
   void freeTask(WTask);
 
@@ -30,18 +32,26 @@ class TaskMap {
   WTask getMarked(Position) const;
   HighlightType getHighlightType(Position) const;
   CostInfo removeTask(WTask);
+  /** Returns the positions of the tasks removed since the last call. Items are no longer marked by a removed
+      task, so they may need to be fetched again.*/
+  vector<Position> extractRemovedPositions();
   CostInfo removeTask(UniqueEntity<Task>::Id);
   CostInfo freeFromTask(WConstCreature);
   bool isPriorityTask(WConstTask) const;
   bool hasPriorityTasks(Position) const;
   void setPriorityTasks(Position);
   WTask getClosestTask(WCreature);
+  /** Matches the workers with the open tasks in a single pass, minimizing their total distance. Priority tasks
+      always go first. getClosestTask() returns the matched task as long as it's still available. Within a turn,
+      the matching is only recomputed when the workers or the tasks change.*/
+  void assignTasks(const vector<WCreature>& workers);
   const EntityMap<Task, CostInfo>& getCompletionCosts() const;
   WTask getTask(UniqueEntity<Task>::Id) const;
 
   SERIALIZATION_DECL(TaskMap);
 
   private:
+  bool isAvailable(WTask, WCreature) const;
   EntityMap<Creature, WTask> SERIAL(taskByCreature);
   EntityMap<Task, WCreature> SERIAL(creatureByTask);
   EntityMap<Task, Position> SERIAL(positionMap);
@@ -53,5 +63,13 @@ class TaskMap {
   EntityMap<Task, CostInfo> SERIAL(completionCost);
   EntityMap<Task, LocalTime> SERIAL(delayedTasks);
   EntitySet<Task> SERIAL(priorityTasks);
+  /** Result of the last assignTasks(). none means that the worker couldn't be matched with any task.*/
+  EntityMap<Creature, optional<UniqueEntity<Task>::Id>> assignedTasks;
+  /** Increased whenever a task is added, removed, moved, freed or prioritized.*/
+  int version = 0;
+  int assignedVersion = -1;
+  vector<UniqueEntity<Creature>::Id> assignedWorkers;
+  optional<LocalTime> assignedTime;
+  vector<Position> removedPositions;
 };
 
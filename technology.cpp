@@ -176,7 +176,7 @@ static void addResource(WCollective col, FurnitureType type, int maxDist) {
       for (auto f : CollectiveConfig::getTrainingFurniture(ExperienceType::SPELL)) {
         auto& pos = col->getConstructions().getBuiltPositions(f);
         if (!pos.empty())
-          return Random.choose(pos);
+          return Random.choose(pos.getElems());
       }
       if (col->hasLeader())
         return col->getLeader()->getPosition();
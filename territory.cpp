@@ -2,26 +2,114 @@
 #include "territory.h"
 #include "position.h"
 #include "movement_type.h"
+#include "level.h"
 
 SERIALIZE_DEF(Territory, allSquares, allSquaresVec, centralPoint)
 
-void Territory::clearCache() {
+void Territory::clearCache() const {
   extendedCache.clear();
   extendedCache2.clear();
 }
 
+void Territory::updateTerrain() const {
+  if (calculatedRadius == 0)
+    return;
+  for (auto& elem : terrainVersions) {
+    WLevel level = elem.first;
+    if (level->getTerrainVersion() == elem.second)
+      continue;
+    auto changes = level->getTerrainChanges(elem.second);
+    elem.second = level->getTerrainVersion();
+    if (!changes) {
+      clearCache();
+      calculateDistances(calculatedRadius);
+      return;
+    }
+    std::sort(changes->begin(), changes->end());
+    changes->resize(std::unique(changes->begin(), changes->end()) - changes->begin());
+    // Only tiles that became blocked while reached, or became enterable while not reached, change the distances.
+    vector<Position> blocked;
+    vector<Position> opened;
+    for (Vec2 v : *changes) {
+      Position pos(v, level);
+      if (contains(pos))
+        continue;
+      bool reached = distance.get(pos) > 0;
+      bool canEnter = pos.canEnterEmpty({MovementTrait::WALK});
+      if (reached && !canEnter)
+        blocked.push_back(pos);
+      else if (!reached && canEnter)
+        opened.push_back(pos);
+    }
+    if (blocked.empty() && opened.empty())
+      continue;
+    clearCache();
+    // Each blocked tile costs a lookup per square of its area, which is a few times cheaper than searching from
+    // every extended square.
+    int area = (2 * calculatedRadius + 1) * (2 * calculatedRadius + 1);
+    if (blocked.size() * area > 4 * extendedSquares.size()) {
+      calculateDistances(calculatedRadius);
+      return;
+    }
+    for (Position pos : blocked)
+      resetDistances(pos);
+    vector<vector<Position>> queue(calculatedRadius + 1);
+    for (Position pos : blocked)
+      addToQueue(pos, calculatedRadius, queue);
+    for (Position pos : opened)
+      addToQueue(pos, 1, queue);
+    propagateDistances(queue);
+  }
+}
+
+void Territory::resetDistances(Position pos) const {
+  // Only squares within calculatedRadius - 1 steps could have been reached through the square.
+  for (Vec2 v : Rectangle::centered(pos.getCoord(), calculatedRadius - 1)) {
+    Position p(v, pos.getLevel());
+    if (!contains(p) && distance.get(p) > 0)
+      setDistance(p, 0);
+  }
+}
+
+void Territory::addToQueue(Position pos, int radius, vector<vector<Position>>& queue) const {
+  for (Vec2 v : Rectangle::centered(pos.getCoord(), radius)) {
+    Position p(v, pos.getLevel());
+    if (int dist = distance.get(p))
+      queue[dist].push_back(p);
+  }
+}
+
 void Territory::insert(Position pos) {
+  updateTerrain();
   if (!allSquares.count(pos)) {
     allSquaresVec.push_back(pos);
     allSquares.insert(pos);
     clearCache();
+    if (calculatedRadius > 0) {
+      WLevel level = pos.getLevel();
+      if (!terrainVersions.contains(make_pair(level, level->getTerrainVersion())))
+        terrainVersions.push_back({level, level->getTerrainVersion()});
+      vector<vector<Position>> queue(calculatedRadius + 1);
+      setDistance(pos, 1);
+      queue[1].push_back(pos);
+      propagateDistances(queue);
+    }
   }
 }
 
 void Territory::remove(Position pos) {
+  updateTerrain();
   allSquaresVec.removeElement(pos);
   allSquares.erase(pos);
   clearCache();
+  if (calculatedRadius > 0) {
+    // Reset the squares that could have been reached through the removed square and search again from
+    // the squares around them.
+    resetDistances(pos);
+    vector<vector<Position>> queue(calculatedRadius + 1);
+    addToQueue(pos, calculatedRadius, queue);
+    propagateDistances(queue);
+  }
 }
 
 void Territory::setCentralPoint(Position pos) {
@@ -36,27 +124,86 @@ const vector<Position>& Territory::getAll() const {
   return allSquaresVec;
 }
 
-vector<Position> Territory::calculateExtended(int minRadius, int maxRadius) const {
-  map<Position, int> extendedTiles;
-  vector<Position> extendedQueue;
-  for (Position pos : allSquaresVec) {
-    if (!extendedTiles.count(pos))  {
-      extendedTiles[pos] = 1;
-      extendedQueue.push_back(pos);
+void Territory::setDistance(Position pos, int dist) const {
+  bool wasExtended = distance.get(pos) > 0;
+  if (dist > 0 && !wasExtended) {
+    extendedIndex.set(pos, extendedSquares.size());
+    extendedSquares.push_back(pos);
+    Vec2 v = pos.getCoord();
+    int index = 0;
+    while (index < extendedBounds.size() && extendedBounds[index].first != pos.getLevel())
+      ++index;
+    if (index == extendedBounds.size())
+      extendedBounds.push_back({pos.getLevel(), Rectangle(v, v + Vec2(1, 1))});
+    else {
+      Rectangle& bounds = extendedBounds[index].second;
+      bounds = Rectangle(min(bounds.left(), v.x), min(bounds.top(), v.y), max(bounds.right(), v.x + 1),
+          max(bounds.bottom(), v.y + 1));
     }
+  } else if (dist == 0 && wasExtended) {
+    int index = extendedIndex.get(pos);
+    extendedSquares[index] = extendedSquares.back();
+    extendedIndex.set(extendedSquares[index], index);
+    extendedSquares.pop_back();
   }
-  for (int i = 0; i < extendedQueue.size(); ++i) {
-    Position pos = extendedQueue[i];
-    for (Position v : pos.neighbors8())
-      if (!contains(v) && !extendedTiles.count(v) && v.canEnterEmpty({MovementTrait::WALK})) {
-        int a = extendedTiles[v] = extendedTiles[pos] + 1;
-        if (a < maxRadius)
-          extendedQueue.push_back(v);
-      }
+  distance.set(pos, dist);
+}
+
+void Territory::propagateDistances(vector<vector<Position>>& queue) const {
+  for (int dist = 1; dist < calculatedRadius; ++dist)
+    for (int i = 0; i < queue[dist].size(); ++i) {
+      Position pos = queue[dist][i];
+      if (distance.get(pos) != dist)
+        continue;
+      for (Position v : pos.neighbors8())
+        if (!contains(v) && v.canEnterEmpty({MovementTrait::WALK})) {
+          int current = distance.get(v);
+          if (current == 0 || current > dist + 1) {
+            setDistance(v, dist + 1);
+            queue[dist + 1].push_back(v);
+          }
+        }
+    }
+}
+
+void Territory::calculateDistances(int radius) const {
+  distance = PositionMap<int>();
+  extendedIndex = PositionMap<int>();
+  extendedSquares.clear();
+  extendedBounds.clear();
+  calculatedRadius = radius;
+  terrainVersions.clear();
+  vector<vector<Position>> queue(calculatedRadius + 1);
+  for (Position pos : allSquaresVec) {
+    WLevel level = pos.getLevel();
+    if (!terrainVersions.contains(make_pair(level, level->getTerrainVersion())))
+      terrainVersions.push_back({level, level->getTerrainVersion()});
+    setDistance(pos, 1);
+    queue[1].push_back(pos);
   }
-  if (minRadius > 0)
-    return extendedQueue.filter([&] (const Position& v) { return extendedTiles.at(v) >= minRadius; });
-  return extendedQueue;
+  propagateDistances(queue);
+}
+
+bool Territory::isInExtended(Position pos, int minRadius, int maxRadius) const {
+  updateTerrain();
+  if (maxRadius > calculatedRadius)
+    calculateDistances(maxRadius);
+  int dist = distance.get(pos);
+  return dist > 0 && dist >= minRadius && (dist < maxRadius || dist == 1);
+}
+
+bool Territory::isInStandardExtended(Position pos) const {
+  return isInExtended(pos, 2, 10);
+}
+
+vector<Position> Territory::calculateExtended(int minRadius, int maxRadius) const {
+  if (maxRadius > calculatedRadius)
+    calculateDistances(maxRadius);
+  vector<Position> ret;
+  for (Position v : extendedSquares)
+    if (isInExtended(v, minRadius, maxRadius))
+      ret.push_back(v);
+  return ret;
 }
 
 const vector<Position>& Territory::getStandardExtended() const {
@@ -64,17 +211,26 @@ const vector<Position>& Territory::getStandardExtended() const {
 }
 
 const vector<Position>& Territory::getExtended(int min, int max) const {
+  updateTerrain();
   if (!extendedCache.count(make_pair(min, max)))
     extendedCache[make_pair(min, max)] = calculateExtended(min, max);
   return extendedCache.at(make_pair(min, max));
 }
 
 const vector<Position>& Territory::getExtended(int max) const {
+  updateTerrain();
   if (!extendedCache2.count(max))
     extendedCache2[max] = calculateExtended(0, max);
   return extendedCache2.at(max);
 }
 
+const vector<pair<WLevel, Rectangle>>& Territory::getExtendedBounds(int max) const {
+  updateTerrain();
+  if (max > calculatedRadius)
+    calculateDistances(max);
+  return extendedBounds;
+}
+
 bool Territory::isEmpty() const {
   return allSquaresVec.empty();
 }
@@ -2,6 +2,7 @@
 
 #include "util.h"
 #include "position.h"
+#include "position_map.h"
 
 class Territory {
   public:
@@ -14,6 +15,12 @@ class Territory {
   const vector<Position>& getExtended(int min, int max) const;
   const vector<Position>& getExtended(int max) const;
   const vector<Position>& getStandardExtended() const;
+  /** Checks in constant time if the position belongs to getExtended(min, max).*/
+  bool isInExtended(Position, int min, int max) const;
+  bool isInStandardExtended(Position) const;
+  /** Rectangles that contain getExtended(max) on every level it touches. They grow as the distances are updated
+      and can be larger than needed, until the distances are fully recalculated.*/
+  const vector<pair<WLevel, Rectangle>>& getExtendedBounds(int max) const;
   bool isEmpty() const;
   const optional<Position>& getCentralPoint() const;
 
@@ -21,11 +28,27 @@ class Territory {
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  void clearCache();
+  void clearCache() const;
+  /** Updates the distances around the tiles whose terrain changed on the levels they cover.*/
+  void updateTerrain() const;
+  void resetDistances(Position) const;
+  void addToQueue(Position, int radius, vector<vector<Position>>& queue) const;
   vector<Position> calculateExtended(int minRadius, int maxRadius) const;
+  void calculateDistances(int maxRadius) const;
+  void propagateDistances(vector<vector<Position>>& queue) const;
+  void setDistance(Position, int) const;
   set<Position> SERIAL(allSquares);
   vector<Position> SERIAL(allSquaresVec);
   optional<Position> SERIAL(centralPoint);
+  /** Walking distance from the territory, which is 1 for the territory itself and 0 for squares that are further
+      than calculatedRadius. It's updated incrementally when squares are inserted or removed.*/
+  mutable PositionMap<int> distance;
+  mutable vector<PackedPosition> extendedSquares;
+  mutable PositionMap<int> extendedIndex;
+  mutable vector<pair<WLevel, Rectangle>> extendedBounds;
+  mutable int calculatedRadius = 0;
+  /** Terrain versions of the levels covered by the distances when they were last updated.*/
+  mutable vector<pair<WLevel, int>> terrainVersions;
   mutable map<pair<int, int>, vector<Position>> extendedCache;
   mutable map<int, vector<Position>> extendedCache2;
 };
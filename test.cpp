@@ -33,6 +33,14 @@
 #include "serialization.h"
 #include "text_serialization.h"
 #include "creature_factory.h"
+#include "entity_map.h"
+#include "entity_set.h"
+#include "bucket_map.h"
+#include "position_set.h"
+#include "model.h"
+#include "level.h"
+#include "level_builder.h"
+#include "lasting_effect.h"
 
 class Test {
   public:
@@ -550,6 +558,21 @@ class Test {
     CHECK(equipment.isOwner(sword2.get(), human2.get()));
   }
 
+  void testMinionEquipmentRemoveLostItems() {
+    PItem sword = ItemType(ItemType::Sword{}).get();
+    PItem sword2 = ItemType(ItemType::Sword{}).get();
+    PCreature human = CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit());
+    PCreature human2 = CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit());
+    MinionEquipment equipment;
+    CHECK(equipment.tryToOwn(human.get(), sword.get()));
+    CHECK(equipment.tryToOwn(human2.get(), sword2.get()));
+    // Only sword2 is still in the collective, e.g. because sword was thrown away.
+    equipment.removeLostItems({human.get(), human2.get()}, [&] { return vector<WItem>{sword2.get()}; });
+    CHECK(equipment.getItemsOwnedBy(human.get()).empty());
+    CHECK(!equipment.getOwner(sword.get()));
+    CHECK(equipment.isOwner(sword2.get(), human2.get()));
+  }
+
   void testMinionEquipmentUpdateOwners() {
     PItem sword1 = ItemType(ItemType::Sword{}).get();
     PItem sword2 = ItemType(ItemType::Sword{}).get();
@@ -776,6 +799,184 @@ class Test {
     CHECKEQ(cache.getSize(), 3);
   }
 
+  void testCacheTemplate3() {
+    TestCache cache(50);
+    for (int i : Range(1000))
+      CHECKEQ(cache.get(bindMethod<string>(&Test::genString1, this), 123, i % 100), toString(i % 100));
+    CHECKEQ(cache.getNumMisses(), 1000);
+    CHECKEQ(cache.getSize(), 50);
+    for (int i : Range(1000))
+      CHECKEQ(cache.get(bindMethod<string>(&Test::genString1, this), 123, i % 40), toString(i % 40));
+    CHECKEQ(cache.getNumMisses(), 1040);
+    CHECKEQ(cache.getNumHits(), 960);
+    CHECK(cache.contains(123, 39));
+    CHECK(cache.contains(123, 99));
+    CHECK(!cache.contains(123, 89));
+  }
+
+  void testEntityMap() {
+    EntityMap<Creature, int> entityMap;
+    vector<Creature::Id> ids;
+    for (int i : Range(100)) {
+      ids.emplace_back();
+      entityMap.set(ids.back(), i);
+    }
+    for (int i : Range(100))
+      if (i % 3 == 0)
+        entityMap.erase(ids[i]);
+    CHECKEQ(entityMap.getSize(), 66);
+    for (int i : Range(100))
+      CHECK(entityMap.getMaybe(ids[i]) == (i % 3 == 0 ? none : optional<int>(i)));
+    entityMap.getOrInit(ids[0]) = 5;
+    CHECKEQ(entityMap.getOrFail(ids[0]), 5);
+    int sum = 0;
+    for (auto& elem : entityMap)
+      sum += elem.second;
+    CHECKEQ(entityMap.getSize(), 67);
+    CHECKEQ(sum, 3272);
+  }
+
+  void testEntitySet() {
+    EntitySet<Creature> entitySet;
+    vector<Creature::Id> ids;
+    for (int i : Range(100)) {
+      ids.emplace_back();
+      entitySet.insert(ids.back());
+      entitySet.insert(ids.back());
+    }
+    CHECKEQ(entitySet.getSize(), 100);
+    size_t hash = entitySet.getHash();
+    for (int i : Range(50))
+      entitySet.erase(ids[i]);
+    for (int i : Range(100))
+      CHECK(entitySet.contains(ids[i]) == (i >= 50));
+    for (int i : Range(50))
+      entitySet.insert(ids[i]);
+    CHECKEQ(entitySet.getHash(), hash);
+    entitySet.clear();
+    CHECK(entitySet.empty() && !entitySet.contains(ids[0]));
+  }
+
+  void checkClosest(const CreatureBucketMap& bucketMap, const vector<PCreature>& creatures, Vec2 pos, int maxDist,
+      int maxCount, function<bool(WCreature)> predicate) {
+    vector<int> expected;
+    for (auto& c : creatures)
+      if (predicate(c.get()) && c->getPosition().getCoord().dist8(pos) <= maxDist)
+        expected.push_back(c->getPosition().getCoord().dist8(pos));
+    std::sort(expected.begin(), expected.end());
+    expected.resize(min<int>(expected.size(), maxCount));
+    vector<WCreature> result;
+    bucketMap.getClosest(pos, maxDist, maxCount, predicate, result);
+    vector<int> distances;
+    EntitySet<Creature> distinct;
+    for (WCreature c : result) {
+      CHECK(predicate(c));
+      distances.push_back(c->getPosition().getCoord().dist8(pos));
+      distinct.insert(c);
+    }
+    // Among creatures at the same distance any can be returned, so only the distances are compared.
+    CHECKEQ(distances, expected);
+    CHECKEQ(distinct.getSize(), result.size());
+    WCreature closest = bucketMap.getClosest(pos, maxDist, predicate);
+    CHECK(expected.empty() ? !closest : closest && closest->getPosition().getCoord().dist8(pos) == expected[0]);
+  }
+
+  void testBucketMapClosest() {
+    const int bucketSize = 8;
+    CreatureBucketMap bucketMap(40, 30, bucketSize);
+    vector<PCreature> creatures;
+    auto addCreature = [&](Vec2 pos) {
+      creatures.push_back(CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit()));
+      creatures.back()->setPosition(Position(pos, nullptr));
+      bucketMap.addElement(pos, creatures.back().get());
+    };
+    // Ties at the same distance in four different buckets.
+    for (Vec2 v : {Vec2(4, 8), Vec2(12, 8), Vec2(8, 4), Vec2(8, 12)})
+      addCreature(v);
+    auto all = [](WCreature) { return true; };
+    checkClosest(bucketMap, creatures, Vec2(8, 8), 4, 2, all);
+    checkClosest(bucketMap, creatures, Vec2(8, 8), 3, 2, all);
+    checkClosest(bucketMap, creatures, Vec2(8, 8), 100, 10, all);
+    for (int i : Range(60))
+      addCreature(Vec2(Random.get(40), Random.get(30)));
+    vector<WCreature> odd;
+    for (int i : All(creatures))
+      if (i % 2 == 1)
+        odd.push_back(creatures[i].get());
+    auto oddOnly = [&](WCreature c) { return odd.contains(c); };
+    for (int i : Range(500)) {
+      Vec2 pos(Random.get(40), Random.get(30));
+      // Distances at and around the bucket edges.
+      for (int maxDist : {0, 1, bucketSize - 1, bucketSize, bucketSize + 1, 2 * bucketSize, 100}) {
+        int maxCount = Random.get(1, 7);
+        checkClosest(bucketMap, creatures, pos, maxDist, maxCount, all);
+        checkClosest(bucketMap, creatures, pos, maxDist, maxCount, oddOnly);
+      }
+    }
+  }
+
+  void testPositionSet() {
+    PModel model = Model::create();
+    vector<PLevel> levels;
+    for (int i : Range(2))
+      levels.push_back(LevelBuilder(Random, 30, 30, "Test", false)
+          .build(model.get(), LevelMaker::emptyLevel(Random).get(), Random.getLL()));
+    // Coordinates well outside of the level bounds are stored apart from the per-level tables.
+    auto randomPosition = [&] {
+      return Position(Vec2(Random.get(-40, 70), Random.get(-40, 70)), levels[Random.get(2)].get());
+    };
+    PositionSet set;
+    std::set<Position> expected;
+    for (int i : Range(3000)) {
+      Position pos = randomPosition();
+      if (Random.roll(3)) {
+        set.erase(pos);
+        expected.erase(pos);
+      } else {
+        set.insert(pos);
+        expected.insert(pos);
+      }
+      CHECKEQ(set.getSize(), expected.size());
+      CHECK(set.empty() == expected.empty());
+      for (int j : Range(5)) {
+        Position probe = randomPosition();
+        CHECK(set.contains(probe) == (expected.count(probe) > 0));
+      }
+    }
+    CHECK(std::set<Position>(set.begin(), set.end()) == expected);
+    for (auto& pos : expected)
+      CHECK(set.contains(pos));
+    for (auto& pos : copyOf(expected))
+      set.erase(pos);
+    CHECK(set.empty());
+  }
+
+  void testChangedEffectTurns() {
+    // A remote creature was last ticked on turn 10 and is caught up on turn 13.
+    auto turns = Model::getChangedEffectTurns(LocalTime(10), LocalTime(13), {});
+    CHECK(turns.empty());
+    // Poisoned after the tick of turn 12, so only turn 13 is poisoned.
+    turns = Model::getChangedEffectTurns(LocalTime(10), LocalTime(13),
+        {Model::EffectChange{LastingEffect::POISON, LocalTime(12), false}});
+    CHECKEQ(turns.size(), 1);
+    CHECK(turns[0].first == LastingEffect::POISON);
+    CHECKEQ(turns[0].second.before, 0);
+    CHECKEQ(turns[0].second.since, 1);
+    // Regeneration removed after the tick of turn 11 was active on turn 11, while cured poison was active on
+    // turns 11 and 12.
+    turns = Model::getChangedEffectTurns(LocalTime(10), LocalTime(13), {
+        Model::EffectChange{LastingEffect::POISON, LocalTime(10), false},
+        Model::EffectChange{LastingEffect::REGENERATION, LocalTime(11), true},
+        Model::EffectChange{LastingEffect::POISON, LocalTime(12), true}});
+    CHECKEQ(turns.size(), 2);
+    CHECK(turns[0].first == LastingEffect::POISON);
+    CHECKEQ(turns[0].second.before, 2);
+    CHECKEQ(turns[0].second.since, 1);
+    CHECK(turns[1].first == LastingEffect::REGENERATION);
+    CHECKEQ(turns[1].second.before, 1);
+    CHECKEQ(turns[1].second.since, 2);
+  }
+
   struct Tmp123 {
     int SERIAL(a);
     char SERIAL(a1);
@@ -856,6 +1057,7 @@ void testAll() {
   Test().testMinionEquipment1();
   Test().testMinionEquipmentItemDestroyed();
   Test().testMinionEquipmentUpdateItems();
+  Test().testMinionEquipmentRemoveLostItems();
   Test().testMinionEquipmentUpdateOwners();
   Test().testMinionEquipmentAutoAssign();
   Test().testMinionEquipmentLocking();
@@ -869,6 +1071,12 @@ void testAll() {
   Test().testContainerRangeMapConst();
   Test().testCacheTemplate();
   Test().testCacheTemplate2();
+  Test().testCacheTemplate3();
   Test().testTextSerialization();
+  Test().testEntityMap();
+  Test().testEntitySet();
+  Test().testBucketMapClosest();
+  Test().testPositionSet();
+  Test().testChangedEffectTurns();
   INFO << "-----===== OK =====-----";
 }
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "tile_flags.h"
+#include "furniture.h"
+#include "movement_set.h"
+#include "movement_type.h"
+#include "vision_id.h"
+
+static const int numTraitMasks = 1 << EnumInfo<MovementTrait>::size;
+static_assert(numTraitMasks <= 16, "Trait masks don't fit in uint16_t");
+
+static int getTraitMask(const EnumSet<MovementTrait>& traits) {
+  int ret = 0;
+  for (auto trait : traits)
+    ret |= 1 << int(trait);
+  return ret;
+}
+
+TileFlags::TileFlags(Rectangle bounds)
+    : enterMask{Table<uint16_t>(bounds, 0), Table<uint16_t>(bounds, 0)},
+      forcedEnterMask{Table<uint16_t>(bounds, 0), Table<uint16_t>(bounds, 0)},
+      conditions{Table<uint8_t>(bounds, 0), Table<uint8_t>(bounds, 0)},
+      seeThru(bounds, 0), stopProjectiles(bounds, 0) {
+}
+
+bool TileFlags::update(Vec2 pos, const vector<WConstFurniture>& furniture, bool covered, bool onFire,
+    bool forbidden) {
+  auto getState = [&] {
+    return make_tuple(enterMask[0][pos], enterMask[1][pos], forcedEnterMask[0][pos], forcedEnterMask[1][pos],
+        conditions[0][pos], conditions[1][pos], seeThru[pos], stopProjectiles[pos]);
+  };
+  auto oldState = getState();
+  updateMovement(0, pos, furniture, covered, onFire, forbidden);
+  updateMovement(1, pos, furniture.filter([](WConstFurniture f) { return f->getLayer() != FurnitureLayer::MIDDLE; }),
+      covered, onFire, forbidden);
+  seeThru[pos] = stopProjectiles[pos] = 0;
+  for (auto vision : ENUM_ALL(VisionId)) {
+    bool canSee = true;
+    bool stops = false;
+    for (auto f : furniture)
+      if (f->getLayer() == FurnitureLayer::MIDDLE) {
+        canSee = f->canSeeThru(vision);
+        stops = f->stopsProjectiles(vision);
+      }
+    if (canSee)
+      seeThru[pos] |= 1 << int(vision);
+    if (stops)
+      stopProjectiles[pos] |= 1 << int(vision);
+  }
+  return getState() != oldState;
+}
+
+void TileFlags::updateMovement(int variant, Vec2 pos, const vector<WConstFurniture>& furniture, bool covered,
+    bool onFire, bool forbidden) {
+  // Mirrors Position::canEnterEmpty: the first furniture that overrides movement decides alone.
+  vector<const MovementSet*> layers;
+  for (auto f : furniture) {
+    if (f->overridesMovement()) {
+      layers = {&f->getMovementSet()};
+      break;
+    }
+    layers.push_back(&f->getMovementSet());
+  }
+  uint16_t& normal = enterMask[variant][pos];
+  uint16_t& forced = forcedEnterMask[variant][pos];
+  uint8_t& cond = conditions[variant][pos];
+  normal = forced = cond = 0;
+  for (int mask : Range(numTraitMasks)) {
+    bool canEnter = true;
+    bool canEnterForced = true;
+    for (auto layer : layers) {
+      int layerMask = getTraitMask(layer->getTraits());
+      canEnter &= !!(layerMask & mask);
+      canEnterForced &= !!((layerMask | getTraitMask(layer->getForcibleTraits())) & mask);
+    }
+    if (canEnter)
+      normal |= 1 << mask;
+    if (canEnterForced)
+      forced |= 1 << mask;
+  }
+  if (!layers.empty()) {
+    if (!covered)
+      cond |= UNCOVERED;
+    if (onFire)
+      cond |= ON_FIRE;
+    if (forbidden)
+      cond |= FORBIDDEN;
+  }
+  for (auto layer : layers)
+    if (layer->isBlockingEnemies())
+      cond |= BLOCKING_ENEMIES;
+}
+
+optional<bool> TileFlags::canEnterEmpty(Vec2 pos, const MovementType& type, bool ignoreMiddle) const {
+  int variant = ignoreMiddle ? 1 : 0;
+  auto cond = conditions[variant][pos];
+  if (cond & BLOCKING_ENEMIES)
+    return none;
+  int mask = getTraitMask(type.getTraits());
+  if (type.isForced())
+    return !!(forcedEnterMask[variant][pos] & (1 << mask));
+  if (((cond & UNCOVERED) && type.isSunlightVulnerable()) || ((cond & ON_FIRE) && !type.isFireResistant()))
+    return false;
+  if (cond & FORBIDDEN)
+    return none;
+  return !!(enterMask[variant][pos] & (1 << mask));
+}
+
+bool TileFlags::canSeeThru(Vec2 pos, VisionId vision) const {
+  return seeThru[pos] & (1 << int(vision));
+}
+
+bool TileFlags::stopsProjectiles(Vec2 pos, VisionId vision) const {
+  return stopProjectiles[pos] & (1 << int(vision));
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util.h"
+
+class MovementType;
+class Furniture;
+
+/** Movement and vision flags of every tile of a level, derived from its squares and furniture and packed into
+    flat tables, so that the hot movement and vision queries don't have to visit the square and each furniture
+    layer. Tiles whose answer depends on the creature's tribe are left to the caller.*/
+class TileFlags {
+  public:
+  TileFlags(Rectangle bounds = Rectangle(0, 0));
+
+  /** Recomputes the flags of a tile and returns whether they changed. The furniture must be ordered by layer.*/
+  bool update(Vec2, const vector<WConstFurniture>&, bool covered, bool onFire, bool forbidden);
+
+  /** Returns none if the answer depends on a tribe, and the furniture needs to be checked.*/
+  optional<bool> canEnterEmpty(Vec2, const MovementType&, bool ignoreMiddle) const;
+  bool canSeeThru(Vec2, VisionId) const;
+  bool stopsProjectiles(Vec2, VisionId) const;
+
+  private:
+  enum Condition {
+    UNCOVERED = 1,
+    ON_FIRE = 2,
+    FORBIDDEN = 4,
+    BLOCKING_ENEMIES = 8
+  };
+  void updateMovement(int variant, Vec2, const vector<WConstFurniture>&, bool covered, bool onFire, bool forbidden);
+  // Indexed by whether the MIDDLE layer is ignored. Bit i of a mask is set if a movement type whose traits
+  // form the bitmask i can enter the tile.
+  Table<uint16_t> enterMask[2];
+  Table<uint16_t> forcedEnterMask[2];
+  Table<uint8_t> conditions[2];
+  Table<uint8_t> seeThru;
+  Table<uint8_t> stopProjectiles;
+};
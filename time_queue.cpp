@@ -21,130 +21,122 @@
 
 template <class Archive> 
 void TimeQueue::serialize(Archive& ar, const unsigned int version) { 
-  ar(creatures, timeMap, queue);
+  ar(creatures, nodes, slots, firstKey);
+  if (Archive::is_loading::value)
+    creatureRefs = getWeakPointers(creatures);
 }
 
 SERIALIZABLE(TimeQueue);
 
 void TimeQueue::addCreature(PCreature c, LocalTime time) {
-  timeMap.set(c.get(), time);
-  queue[time].push(c.get());
+  pushBack(c.get(), time);
+  creatureRefs.push_back(c.get());
   creatures.push_back(std::move(c));
 }
 
 LocalTime TimeQueue::getTime(WConstCreature c) {
-  return timeMap.getOrFail(c).time;
+  return nodes.getOrFail(c).time.time;
 }
 
-static void clearNull(deque<WCreature>& q) {
-  while (!q.empty() && q.back() == nullptr)
-    q.pop_back();
-  while (!q.empty() && q.front() == nullptr)
-    q.pop_front();
+bool TimeQueue::Slot::empty() const {
+  return !players.front && !nonPlayers.front;
 }
 
-void TimeQueue::Queue::clearNull() {
-  ::clearNull(players);
-  ::clearNull(nonPlayers);
-}
-
-void TimeQueue::Queue::push(WCreature c) {
-  clearNull();
-  if (c->isPlayer()) {
-    int order = players.empty() ? 0 : orderMap.getOrFail(players.back()) + 1;
-    orderMap.set(c, order);
-    players.push_back(c);
-  } else {
-    int order = nonPlayers.empty() ? 1000000000 : orderMap.getOrFail(nonPlayers.back()) + 1;
-    orderMap.set(c, order);
-    nonPlayers.push_back(c);
-  }
-}
-
-void TimeQueue::Queue::pushFront(WCreature c) {
-  clearNull();
-  if (c->isPlayer()) {
-    int order = players.empty() ? 0 : orderMap.getOrFail(players.front()) - 1;
-    orderMap.set(c, order);
-    players.push_front(c);
-  } else {
-    int order = nonPlayers.empty() ? 1000000000 : orderMap.getOrFail(nonPlayers.front()) - 1;
-    orderMap.set(c, order);
-    nonPlayers.push_front(c);
-  }
-}
-
-bool TimeQueue::Queue::empty() {
-  clearNull();
-  return players.empty() && nonPlayers.empty();
-}
-
-WCreature TimeQueue::Queue::front() {
-  clearNull();
-  if (!players.empty())
-    return players.front();
+WCreature TimeQueue::Slot::front() const {
+  if (players.front)
+    return players.front;
   else
-    return nonPlayers.front();
+    return nonPlayers.front;
+}
+
+TimeQueue::Slot& TimeQueue::getSlot(ExtendedTime time) {
+  int key = time.getKey();
+  if (slots.empty())
+    firstKey = key;
+  for (; key < firstKey; --firstKey)
+    slots.emplace_front();
+  while (key - firstKey >= slots.size())
+    slots.emplace_back();
+  return slots[key - firstKey];
+}
+
+void TimeQueue::pushBack(WCreature c, ExtendedTime time) {
+  bool player = c->isPlayer();
+  auto& list = player ? getSlot(time).players : getSlot(time).nonPlayers;
+  int order = !list.back ? (player ? 0 : 1000000000) : nodes.getOrFail(list.back).order + 1;
+  nodes.set(c, Node{time, order, player, list.back, nullptr});
+  if (list.back)
+    nodes.getOrFail(list.back).next = c;
+  else
+    list.front = c;
+  list.back = c;
 }
 
-void TimeQueue::Queue::popFront() {
-  if (!players.empty())
-    return players.pop_front();
+void TimeQueue::pushFront(WCreature c, ExtendedTime time) {
+  bool player = c->isPlayer();
+  auto& list = player ? getSlot(time).players : getSlot(time).nonPlayers;
+  int order = !list.front ? (player ? 0 : 1000000000) : nodes.getOrFail(list.front).order - 1;
+  nodes.set(c, Node{time, order, player, nullptr, list.front});
+  if (list.front)
+    nodes.getOrFail(list.front).prev = c;
   else
-    return nonPlayers.pop_front();
+    list.back = c;
+  list.front = c;
 }
 
-void TimeQueue::Queue::erase(WCreature c) {
-  auto eraseFrom = [&c] (deque<WCreature>& queue) {
-    for (int i : All(queue))
-      if (queue[i] == c) {
-        queue[i] = nullptr;
-        break;
-      }
-  };
-  eraseFrom(players);
-  eraseFrom(nonPlayers);
+void TimeQueue::unlink(WCreature c) {
+  auto& node = nodes.getOrFail(c);
+  auto& slot = getSlot(node.time);
+  auto& list = node.player ? slot.players : slot.nonPlayers;
+  if (node.prev)
+    nodes.getOrFail(node.prev).next = node.next;
+  else
+    list.front = node.next;
+  if (node.next)
+    nodes.getOrFail(node.next).prev = node.prev;
+  else
+    list.back = node.prev;
 }
 
 void TimeQueue::increaseTime(WCreature c, TimeInterval diff) {
-  auto& time = timeMap.getOrFail(c);
-  queue.at(time).erase(c);
+  auto time = nodes.getOrFail(c).time;
+  unlink(c);
   time.time += diff;
   time.extraTurn = false;
-  queue[time].push(c);
+  pushBack(c, time);
 }
 
 void TimeQueue::makeExtraMove(WCreature c) {
-  auto& time = timeMap.getOrFail(c);
-  queue.at(time).erase(c);
+  auto time = nodes.getOrFail(c).time;
+  unlink(c);
   if (!time.extraTurn)
     time.extraTurn = true;
   else {
     time.time += 1_visible;
     time.extraTurn = false;
   }
-  queue[time].push(c);
+  pushBack(c, time);
 }
 
 bool TimeQueue::hasExtraMove(WCreature c) {
-  return timeMap.getOrFail(c).extraTurn;
+  return nodes.getOrFail(c).time.extraTurn;
 }
 
 void TimeQueue::postponeMove(WCreature c) {
-  auto time = timeMap.getOrFail(c);
-  queue.at(time).erase(c);
-  queue.at(time).push(c);
+  auto time = nodes.getOrFail(c).time;
+  unlink(c);
+  pushBack(c, time);
 }
 
 void TimeQueue::moveNow(WCreature c) {
-  auto time = timeMap.getOrFail(c);
-  queue.at(time).erase(c);
-  queue.at(time).pushFront(c);
+  auto time = nodes.getOrFail(c).time;
+  unlink(c);
+  pushFront(c, time);
 }
 
 bool TimeQueue::willMoveThisTurn(WConstCreature c) {
-  auto hisTime = timeMap.getOrFail(c);
-  auto curTime = queue.begin()->first;
+  auto hisTime = nodes.getOrFail(c).time;
+  auto curTime = ExtendedTime::fromKey(firstKey);
   return hisTime.time == curTime.time && (!hisTime.extraTurn || curTime.extraTurn);
 }
 
@@ -155,14 +147,13 @@ bool TimeQueue::compareOrder(WConstCreature c1, WConstCreature c2) {
     return false;
   if (!willMoveThisTurn(c1))
     return c1->getLastMoveCounter() < c2->getLastMoveCounter();
-  auto time1 = timeMap.getOrFail(c1);
-  auto time2 = timeMap.getOrFail(c2);
-  if (time1 < time2)
+  auto& node1 = nodes.getOrFail(c1);
+  auto& node2 = nodes.getOrFail(c2);
+  if (node1.time < node2.time)
     return true;
-  if (time2 < time1)
+  if (node2.time < node1.time)
     return false;
-  auto& orderMap = queue.at(time1).orderMap;
-  return orderMap.getOrFail(c1) < orderMap.getOrFail(c2);
+  return node1.order < node2.order;
 }
 
 TimeQueue::TimeQueue() {}
@@ -170,46 +161,54 @@ TimeQueue::TimeQueue() {}
 PCreature TimeQueue::removeCreature(WCreature cRef) {
   for (int i : All(creatures))
     if (creatures[i].get() == cRef) {
-      queue.at(timeMap.getOrFail(cRef)).erase(cRef);
+      unlink(cRef);
+      nodes.erase(cRef);
       PCreature ret = std::move(creatures[i]);
       creatures.removeIndexPreserveOrder(i);
+      creatureRefs.removeIndexPreserveOrder(i);
       return ret;
     }
   FATAL << "Creature not found";
   return nullptr;
 }
 
-vector<WCreature> TimeQueue::getAllCreatures() const {
-  return getWeakPointers(creatures);
+const vector<WCreature>& TimeQueue::getAllCreatures() const {
+  return creatureRefs;
 }
 
 WCreature TimeQueue::getNextCreature(double maxTime) {
   if (creatures.empty())
     return nullptr;
   while (1) {
-    CHECK(!queue.empty());
-    if (!queue.begin()->second.empty())
+    CHECK(!slots.empty());
+    if (!slots.front().empty())
       break;
-    queue.erase(queue.begin());
+    slots.pop_front();
+    ++firstKey;
   }
-  auto nowTime = queue.begin()->first;
+  auto nowTime = ExtendedTime::fromKey(firstKey);
   if (nowTime.getDouble() > maxTime)
     return nullptr;
-  auto& q = queue.begin()->second;
-  if (!nowTime.extraTurn) {
-    auto nextQueue = ++queue.begin();
-    if (nextQueue != queue.end()) {
-      if (nextQueue->first.time == nowTime.time && !nextQueue->second.empty() && nextQueue->second.front()->isPlayer())
-        return nextQueue->second.front();
-    }
-  }
-  return q.front();
+  // A player with an extra move this turn goes before creatures without one.
+  if (!nowTime.extraTurn && slots.size() > 1 && !slots[1].empty() && slots[1].front()->isPlayer())
+    return slots[1].front();
+  return slots.front().front();
 }
 
 TimeQueue::ExtendedTime::ExtendedTime() {}
 
 TimeQueue::ExtendedTime::ExtendedTime(LocalTime t) : time(t) {}
 
+TimeQueue::ExtendedTime TimeQueue::ExtendedTime::fromKey(int key) {
+  ExtendedTime ret(LocalTime(key >> 1));
+  ret.extraTurn = key & 1;
+  return ret;
+}
+
+int TimeQueue::ExtendedTime::getKey() const {
+  return 2 * time.getInternal() + (extraTurn ? 1 : 0);
+}
+
 double TimeQueue::ExtendedTime::getDouble() const {
   double ret = time.getDouble();
   if (extraTurn)
@@ -27,7 +27,7 @@ class TimeQueue {
   public:
   TimeQueue();
   WCreature getNextCreature(double maxTime);
-  vector<WCreature> getAllCreatures() const;
+  const vector<WCreature>& getAllCreatures() const;
   void addCreature(PCreature, LocalTime time);
   PCreature removeCreature(WCreature);
   LocalTime getTime(WConstCreature);
@@ -44,31 +44,47 @@ class TimeQueue {
 
   private:
   vector<PCreature> SERIAL(creatures);
-  struct Queue {
-    void push(WCreature);
-    void pushFront(WCreature);
-    bool empty();
-    WCreature front();
-    void popFront();
-    void erase(WCreature);
-    deque<WCreature> SERIAL(players);
-    deque<WCreature> SERIAL(nonPlayers);
-    EntityMap<Creature, int> SERIAL(orderMap);
-    SERIALIZE_ALL(players, nonPlayers, orderMap)
-
-    private:
-      void clearNull();
-  };
+  vector<WCreature> creatureRefs;
   struct ExtendedTime {
     ExtendedTime();
     ExtendedTime(LocalTime);
+    static ExtendedTime fromKey(int);
     double getDouble() const;
+    int getKey() const;
     bool operator < (ExtendedTime) const;
     LocalTime SERIAL(time);
     bool SERIAL(extraTurn) = false;
     SERIALIZE_ALL(time, extraTurn)
   };
-  map<ExtendedTime, Queue> SERIAL(queue);
-  EntityMap<Creature, ExtendedTime> SERIAL(timeMap);
+  /** Intrusive links of a creature in the list of creatures scheduled for the same time.*/
+  struct Node {
+    ExtendedTime SERIAL(time);
+    int SERIAL(order);
+    bool SERIAL(player);
+    WCreature SERIAL(prev);
+    WCreature SERIAL(next);
+    SERIALIZE_ALL(time, order, player, prev, next)
+  };
+  struct List {
+    WCreature SERIAL(front);
+    WCreature SERIAL(back);
+    SERIALIZE_ALL(front, back)
+  };
+  /** Creatures that move at the same time, players first.*/
+  struct Slot {
+    bool empty() const;
+    WCreature front() const;
+    List SERIAL(players);
+    List SERIAL(nonPlayers);
+    SERIALIZE_ALL(players, nonPlayers)
+  };
+  Slot& getSlot(ExtendedTime);
+  void pushBack(WCreature, ExtendedTime);
+  void pushFront(WCreature, ExtendedTime);
+  void unlink(WCreature);
+  /** Calendar of time slots, where slots[i] holds the creatures that move at ExtendedTime::fromKey(firstKey + i).*/
+  deque<Slot> SERIAL(slots);
+  int SERIAL(firstKey) = 0;
+  EntityMap<Creature, Node> SERIAL(nodes);
 };
 
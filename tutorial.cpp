@@ -91,9 +91,9 @@ bool Tutorial::canContinue(WConstGame game) const {
     case State::INTRO2:
       return true;
     case State::CUT_TREES:
-      return collective->getZones().getPositions(ZoneId::FETCH_ITEMS).size() > 0;
+      return collective->getZones().getPositions(ZoneId::FETCH_ITEMS).getSize() > 0;
     case State::BUILD_STORAGE:
-      return collective->getZones().getPositions(ZoneId::STORAGE_RESOURCES).size() >= 9;
+      return collective->getZones().getPositions(ZoneId::STORAGE_RESOURCES).getSize() >= 9;
     case State::CONTROLS1:
     case State::CONTROLS2:
       return true;
@@ -120,7 +120,7 @@ bool Tutorial::canContinue(WConstGame game) const {
       return getHighlightedSquaresLow(game).empty();
     case State::BUILD_WORKSHOP:
       return collective->getConstructions().getBuiltCount(FurnitureType::WORKSHOP) >= 2 &&
-          collective->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT).size() >= 1;
+          collective->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT).getSize() >= 1;
     case State::SCHEDULE_WORKSHOP_ITEMS: {
       int numWeapons = collective->getNumItems(ItemIndex::WEAPON);
       for (auto& item : collective->getWorkshops().get(WorkshopType::WORKSHOP).getQueued())
@@ -419,10 +419,10 @@ vector<Vec2> Tutorial::getHighlightedSquaresLow(WConstGame game) const {
       return ret;
     }
     case State::SCHEDULE_WORKSHOP_ITEMS:
-      return collective->getConstructions().getBuiltPositions(FurnitureType::WORKSHOP).transform(
+      return collective->getConstructions().getBuiltPositions(FurnitureType::WORKSHOP).getElems().transform(
           [](const Position& pos) { return pos.getCoord(); });
     case State::RESEARCH:
-      return collective->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE_WOOD).transform(
+      return collective->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE_WOOD).getElems().transform(
           [](const Position& pos) { return pos.getCoord(); });
     default:
       return {};
@@ -5,37 +5,117 @@
 
 SERIALIZE_DEF(VisibilityMap, lastUpdates, visibilityCount, eyeballs)
 
-void VisibilityMap::addPositions(const vector<Position>& positions) {
-  for (Position v : positions)
+static Vec2 getOrigin(WConstLevel level) {
+  return level->getBounds().topLeft();
+}
+
+VisibilityMap::VisibleTiles::VisibleTiles(const vector<Position>& tiles) {
+  if (tiles.empty())
+    return;
+  level = tiles[0].getLevel();
+  Vec2 origin = getOrigin(level);
+  Rectangle bounds = Rectangle::boundingBox(tiles.transform([&](const Position& pos) {
+      CHECK(pos.getLevel() == level);
+      return pos.getCoord() - origin; }));
+  top = bounds.top();
+  leftWord = bounds.left() / 64;
+  numWords = (bounds.right() - 1) / 64 - leftWord + 1;
+  bits = vector<uint64_t>(bounds.height() * numWords, 0);
+  for (auto& pos : tiles) {
+    Vec2 v = pos.getCoord() - origin;
+    bits[(v.y - top) * numWords + v.x / 64 - leftWord] |= uint64_t(1) << (v.x % 64);
+  }
+}
+
+int VisibilityMap::VisibleTiles::getNumRows() const {
+  return numWords > 0 ? bits.size() / numWords : 0;
+}
+
+uint64_t VisibilityMap::VisibleTiles::getWord(int row, int word) const {
+  if (row < top || row >= top + getNumRows() || word < leftWord || word >= leftWord + numWords)
+    return 0;
+  return bits[(row - top) * numWords + word - leftWord];
+}
+
+template <typename Fun>
+void VisibilityMap::VisibleTiles::forEachDifference(const VisibleTiles& prev, Fun fun) const {
+  if (prev.level == level)
+    forEachDifferentTile(prev, fun);
+  else {
+    prev.forEachDifferentTile(VisibleTiles(), [&](Position pos, bool) { fun(pos, false); });
+    forEachDifferentTile(VisibleTiles(), fun);
+  }
+}
+
+template <typename Fun>
+void VisibilityMap::VisibleTiles::forEachDifferentTile(const VisibleTiles& prev, Fun fun) const {
+  if (!level)
+    return;
+  Vec2 origin = getOrigin(level);
+  int minRow = top;
+  int maxRow = top + getNumRows();
+  int minWord = leftWord;
+  int maxWord = leftWord + numWords;
+  if (!prev.bits.empty()) {
+    minRow = min(minRow, prev.top);
+    maxRow = max(maxRow, prev.top + prev.getNumRows());
+    minWord = min(minWord, prev.leftWord);
+    maxWord = max(maxWord, prev.leftWord + prev.numWords);
+  }
+  for (int row = minRow; row < maxRow; ++row)
+    for (int word = minWord; word < maxWord; ++word) {
+      uint64_t cur = getWord(row, word);
+      uint64_t diff = cur ^ prev.getWord(row, word);
+      while (diff) {
+        int bit = __builtin_ctzll(diff);
+        diff &= diff - 1;
+        fun(Position(origin + Vec2(word * 64 + bit, row), level), !!(cur & (uint64_t(1) << bit)));
+      }
+    }
+}
+
+void VisibilityMap::updatePosition(Position v, bool visible) {
+  if (visible) {
     if (++visibilityCount.getOrInit(v) == 1)
       v.setNeedsRenderUpdate(true);
+  } else
+    if (--visibilityCount.getOrFail(v) == 0)
+      v.setNeedsRenderUpdate(true);
+}
+
+void VisibilityMap::addPositions(const vector<Position>& positions) {
+  for (Position v : positions)
+    updatePosition(v, true);
 }
 
 void VisibilityMap::removePositions(const vector<Position>& positions) {
   for (Position v : positions)
-    if (--visibilityCount.getOrFail(v) == 0)
-      v.setNeedsRenderUpdate(true);
+    updatePosition(v, false);
 }
 
 void VisibilityMap::update(WConstCreature c, const vector<Position>& visibleTiles) {
-  remove(c);
-  lastUpdates.set(c, visibleTiles);
-  addPositions(visibleTiles);
+  VisibleTiles tiles(visibleTiles);
+  auto& prev = lastUpdates.getOrInit(c);
+  tiles.forEachDifference(prev, [this](Position pos, bool visible) { updatePosition(pos, visible); });
+  prev = std::move(tiles);
 }
 
 void VisibilityMap::remove(WConstCreature c) {
-  if (auto positions = lastUpdates.getMaybe(c))
-    removePositions(*positions);
-  lastUpdates.erase(c);
+  if (lastUpdates.hasKey(c)) {
+    VisibleTiles().forEachDifference(lastUpdates.getOrFail(c),
+        [this](Position pos, bool visible) { updatePosition(pos, visible); });
+    lastUpdates.erase(c);
+  }
 }
 
 const static Vision eyeballVision;
 
-void VisibilityMap::updateEyeball(Position pos) {
+vector<Position> VisibilityMap::updateEyeball(Position pos) {
   removeEyeball(pos);
   auto visibleTiles = pos.getVisibleTiles(eyeballVision);
   eyeballs.set(pos, visibleTiles);
   addPositions(visibleTiles);
+  return visibleTiles;
 }
 
 void VisibilityMap::removeEyeball(Position pos) {
@@ -44,12 +124,14 @@ void VisibilityMap::removeEyeball(Position pos) {
   eyeballs.set(pos, none);
 }
 
-void VisibilityMap::onVisibilityChanged(Position pos) {
-  if (auto c = pos.getCreature())
-    if (lastUpdates.hasKey(c))
-      update(c, c->getVisibleTiles());
-  if (eyeballs.get(pos))
-    updateEyeball(pos);
+void VisibilityMap::onVisibilityChanged(const vector<Position>& positions) {
+  for (Position pos : positions) {
+    if (auto c = pos.getCreature())
+      if (lastUpdates.hasKey(c))
+        update(c, c->getVisibleTiles());
+    if (eyeballs.get(pos))
+      updateEyeball(pos);
+  }
 }
 
 bool VisibilityMap::isVisible(Position pos) const {
@@ -12,20 +12,45 @@ class VisibilityMap {
   public:
   void update(WConstCreature, const vector<Position>& visibleTiles);
   void remove(WConstCreature);
-  void updateEyeball(Position);
+  /** Returns the tiles that the eyeball sees.*/
+  vector<Position> updateEyeball(Position);
   void removeEyeball(Position);
-  void onVisibilityChanged(Position);
+  void onVisibilityChanged(const vector<Position>&);
   bool isVisible(Position) const;
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  EntityMap<Creature, vector<Position>> SERIAL(lastUpdates);
+  /** Tiles visible by a single creature, packed into a bitset that covers the rows of the level it can see.*/
+  class VisibleTiles {
+    public:
+    VisibleTiles() {}
+    VisibleTiles(const vector<Position>&);
+
+    /** Calls \paramname{fun} for every tile whose visibility differs between \paramname{prev} and this set.
+        The second argument is true if the tile became visible.*/
+    template <typename Fun>
+    void forEachDifference(const VisibleTiles& prev, Fun fun) const;
+
+    SERIALIZE_ALL(level, top, leftWord, numWords, bits)
+
+    private:
+    /** Same as forEachDifference, but assumes that \paramname{prev} is on the same level or empty.*/
+    template <typename Fun>
+    void forEachDifferentTile(const VisibleTiles& prev, Fun fun) const;
+    uint64_t getWord(int row, int word) const;
+    int getNumRows() const;
+    WLevel SERIAL(level) = nullptr;
+    int SERIAL(top) = 0;
+    int SERIAL(leftWord) = 0;
+    int SERIAL(numWords) = 0;
+    vector<uint64_t> SERIAL(bits);
+  };
+  EntityMap<Creature, VisibleTiles> SERIAL(lastUpdates);
   PositionMap<optional<vector<Position>>> SERIAL(eyeballs);
   PositionMap<int> SERIAL(visibilityCount);
   void addPositions(const vector<Position>&);
   void removePositions(const vector<Position>&);
+  void updatePosition(Position, bool visible);
 };
-
-
@@ -9,16 +9,18 @@
 SERIALIZE_DEF(Zones, zones)
 
 bool Zones::isZone(Position pos, ZoneId id) const {
-  return zones[id].count(pos);
+  return zones[id].contains(pos);
 }
 
 void Zones::setZone(Position pos, ZoneId id) {
   zones[id].insert(pos);
+  changedPositions.push_back(pos);
   pos.setNeedsRenderUpdate(true);
 }
 
 void Zones::eraseZone(Position pos, ZoneId id) {
   zones[id].erase(pos);
+  changedPositions.push_back(pos);
   pos.setNeedsRenderUpdate(true);
 }
 
@@ -27,7 +29,13 @@ void Zones::eraseZones(Position pos) {
     eraseZone(pos, id);
 }
 
-const set<Position>& Zones::getPositions(ZoneId id) const {
+vector<Position> Zones::extractChangedPositions() {
+  vector<Position> ret;
+  swap(ret, changedPositions);
+  return ret;
+}
+
+const PositionSet& Zones::getPositions(ZoneId id) const {
   return zones[id];
 }
 
@@ -71,7 +79,7 @@ bool Zones::canSet(Position pos, ZoneId id, WConstCollective col) const {
 }
 
 void Zones::tick() {
-  for (auto pos : copyOf(zones[ZoneId::FETCH_ITEMS]))
+  for (auto pos : copyOf(zones[ZoneId::FETCH_ITEMS].getElems()))
     if (pos.getItems().empty())
       eraseZone(pos, ZoneId::FETCH_ITEMS);
 }
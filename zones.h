@@ -2,6 +2,7 @@
 
 #include "util.h"
 #include "position.h"
+#include "position_set.h"
 
 RICH_ENUM(ZoneId,
   FETCH_ITEMS,
@@ -23,14 +24,17 @@ class Zones {
   void setZone(Position, ZoneId);
   void eraseZone(Position, ZoneId);
   void eraseZones(Position);
-  const set<Position>& getPositions(ZoneId) const;
+  const PositionSet& getPositions(ZoneId) const;
   void setHighlights(Position, ViewIndex&) const;
   bool canSet(Position, ZoneId, WConstCollective) const;
   void tick();
+  /** Returns the positions whose zones changed since the last call.*/
+  vector<Position> extractChangedPositions();
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  EnumMap<ZoneId, set<Position>> SERIAL(zones);
+  EnumMap<ZoneId, PositionSet> SERIAL(zones);
+  vector<Position> changedPositions;
 };